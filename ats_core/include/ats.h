@@ -67,7 +67,11 @@
 // ...
 
 #pragma once
-#include "chrono.h" // Event timing facility
+#include "chrono.h"  // Event timing facility
+#include "hist2d.h"  // Execution time against samples
+#include "metrics.h" // OpenMetrics text export
+#include "perf.h"    // Hardware counters for the calls
+#include "record.h"  // Histogram time series on disk
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
@@ -77,6 +81,14 @@ typedef float AtsData;
 #define ATS_BUFFER_SIZE_LOG2 (12)
 #define ATS_BUFFER_SIZE      (1 << ATS_BUFFER_SIZE_LOG2) // Audio buffer size per channel. Compile time fixed.
 #endif
+#ifdef ATS_STAGE_TIMING
+#define ATS_STAGE_EVENTS (6) // Extra events timing the stages of push and pop
+#else
+#define ATS_STAGE_EVENTS (0)
+#endif
+#define ATS_CHRONO_POOL (768 + 160 * ATS_STAGE_EVENTS) // Bins shared out to the log-linear chronos - exec, stage times and under run size
+#define ATS_EXEC_SAMPLE_BINS 11 // Octaves of samples per call for execOpen - 1 to 1024
+#define ATS_EXEC_TIME_BINS   80 // Log bins of execution time for execOpen - 19% wide from 10ns to 10ms
 
 namespace Audinate { namespace ats {
 
@@ -84,6 +96,7 @@ using namespace Audinate::hist;
 using namespace Audinate::chrono;
 
 struct ats_t;
+class AtsShm;
 
 typedef enum Mode : int
 {
@@ -135,7 +148,10 @@ typedef enum Mode : int
     // ADDITIONAL MODE FLAGS FOR TESTING AND WIDER APPLICATIONS
     //
 
-    ATS_TRACKING_OFF = 0x10000000 // Prevent the tracking from being called during a push - fixed rate
+    ATS_TRACKING_OFF   = 0x10000000, // Prevent the tracking from being called during a push - fixed rate
+    ATS_TRACKING_FIXED = 0x20000000  // Run the tracking loop in integer fixed point - for targets without an FPU
+                                     // The call jitter smoothing and the adaptive offset filter window go integer
+                                     // too, so nothing per call is float
 
 } Mode;
 inline Mode operator|(Mode a, Mode b) { return (Mode)((int)a | (int)b); };
@@ -159,21 +175,34 @@ typedef struct Config
     Mode             mode          = ATS_INTERP_SPLINE5;  // General mode of operation flags with a sensible default
     float            inRate        = 48000.0F;            // The expected input sample rate
     float            outRate       = 48000.0F;            // The expected output sample rate
-    uint32_t         filterPush    = 200;                 // Window size for filtering the push offsets - at push rate
-    uint32_t         filterPop     = 200;                 // Window size for filtering the pop  offsets - at pop rate
+    uint32_t         filterPush    = 200;                 // Window size (maximum if adaptive) for filtering the push offsets - at push rate
+    uint32_t         filterPop     = 200;                 // Window size (maximum if adaptive) for filtering the pop  offsets - at pop rate
+    uint32_t         filterMin     = 50;                  // Minimum adaptive window for the offset filters - 0 fixes them at filterPush/filterPop
+    float            filterJitter  = 48.0F;               // Call jitter (samples) at which the adaptive filters reach full window and 90th percentile
     int              trackTarget   = ATS_BUFFER_SIZE / 4; // The desired latency to track // FIXME: set better default value
     int              trackRange    = 0;                   // Drift before a reset			samples				0 is off
     float            trackKp       = 2.0F;                // Proportional gain 			ppm / samples		1.0 is around 1m to 1 sample at 48kHz
     float            trackKi       = 0.1F;                // Integral gain 				ppm / samples		Typically 1/20 of Ki
     float            trackWarp     = 10.0F;               // Quadratic warp (hysteresis) 	SAMPLES				Scales down Kp by error/warp
     float            trackRate     = 10.0F;               // Maximum rate of tracking		ppm / second		Smooths the tracking
+    uint32_t         chronoSample  = 1;                   // Record the push and pop chronos every Nth call with counts scaled by N - 1 is every call
 } Config;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // EVENTS
 //
 // This is a set of events that are logged in histograms.  The chrono class is very lean, so these are tracked
-// with near zero overhead.  The value of these in diagnostics justify them being always enabled.
+// with near zero overhead.  The value of these in diagnostics justify them being enabled by default.
+//
+// Where there are many streams with small blocks the cost still shows, so Config::chronoSample can record the
+// call chronos (PUSH through POP_EXEC) on only every Nth call, with the histogram counts scaled by N.  Building
+// with ATS_CHRONOS off (ATS_NO_CHRONOS) compiles them all out other than TRACK, which paces the control loop.
+// Without the PUSH_RATE and POP_RATE chronos the call jitter is not known, so the offset filters stay at the
+// full window and 90th percentile.
+//
+// Building with ATS_STAGE_TIMING on adds the stage events, which split PUSH_EXEC and POP_EXEC into the time
+// spent in each part of the call.  These are read from the TSC where available, are sampled along with the
+// call chronos, and are compiled out with them.
 
 enum Event : int // A set of lean chrono time stamper / counters
 {
@@ -189,10 +218,43 @@ enum Event : int // A set of lean chrono time stamper / counters
     DEPTH,          // Sample of the depth of the buffer at each track call
     LATENCY,        // Sample of finer detail around target latency (subject to observation error)
     TRACK,          // Used to ensure tracking is called, and estimate rate of track call for I control
+#ifdef ATS_STAGE_TIMING
+    PUSH_OFFSET,    // Stage of push - offset bookkeeping after the call chronos
+    PUSH_TRACK,     // Stage of push - the tracking update
+    PUSH_DATA,      // Stage of push - copying into the ring
+    POP_OFFSET,     // Stage of pop  - offset bookkeeping and under run check after the call chronos
+    POP_INTERP,     // Stage of pop  - the interpolator
+    POP_CONVERT,    // Stage of pop  - the conversion pass of the int32_t pop
+#endif
     EVENTS,
     ALL = EVENTS
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TRACE RECORDS
+//
+// The state of the control loop at one tracking update, in the order of the columns of Ats::trace.  Records are
+// fixed size and held raw so they can be drained from the ring and written straight to a file, which the
+// ats_trace tool turns back into text.  They are native endian and only read on a like machine.
+//
+typedef struct TraceRecord
+{
+    uint64_t time;         // 1  Time of the update (ns on the push clock source)
+    float    latency;      // 2  Latency from the filtered offsets (samples)
+    uint32_t step;         // 3  Input samples per output sample in 4.28 - the rate is 2^28 / step
+    uint32_t pushRaw;      // 4  Last raw push offset
+    uint32_t pushFiltered; // 5  Filtered push offset used by the update
+    uint32_t popRaw;       // 6  Last raw pop offset
+    uint32_t popFiltered;  // 7  Filtered pop offset used by the update
+    float    prop;         // 8  Proportional adjust (ppb)
+    float    integral;     // 9  Integral adjust (ppb)
+    float    slew;         // 10 Slew limited adjust (ppb)
+    int32_t  depth;        // 11 Buffer depth (samples)
+    uint32_t pushCount;    // 12 Push event count
+    uint32_t popCount;     // 13 Pop event count
+    uint32_t index;        // Updates so far - a gap shows records dropped with the ring full
+} TraceRecord;
+
 class Ats
 {
   public:
@@ -205,6 +267,9 @@ class Ats
     void          skip(int samples);                  
     void          pop(int samples, int sampleStride, int channelStride, AtsData *dst, int64_t callTime = 0);
     void          pop(int samples, int sampleStride, int channelStride, int32_t *dst, int64_t callTime = 0);
+    void          pushTimed(int samples, int sampleStride, int channelStride, int32_t *data, int64_t sampleTime, int64_t sampleIndex = -1);
+    void          popTimed(int samples, int sampleStride, int channelStride, AtsData *dst, int64_t sampleTime, int64_t sampleIndex = -1);
+    void          popTimed(int samples, int sampleStride, int channelStride, int32_t *dst, int64_t sampleTime, int64_t sampleIndex = -1);
     int           getDepth();                                    // Get the current buffer depth
     void          setDepth(int depth);                           // Asynchronously set the depth (will not be the exact latency)
     float         getLatency();                                  // Most recent estimate of the latency, time adjusted.  We cannot set this but we can nudge it
@@ -214,9 +279,118 @@ class Ats
     void          chronoDefault(int bins = 101, float T = 0.01); // Set all chronos and counters to a default configuration
     bool          setRate(double rate);                          // Ratio of target output sample rate to input
     double        getRate();                                     //
+    bool          setRateHint(float ppm, float confidence = 1.0F); // Known input clock offset (ppm fast) to seed the tracking - loop corrects the residual
+    bool          setSource(Event side, ChronoSource source, void *context = nullptr); // Clock for the PUSH or POP side - see below
     void          histogram(Event event, Histogram *h = nullptr);
+    bool          snapshot(Chrono *chronos, uint32_t *storage, int storageBins = ATS_CHRONO_POOL, int tries = 100); // All EVENTS as one epoch
+    bool          perfOpen(Event side);                          // Hardware counters for the PUSH or POP calls - call from that thread, see below
+    Perf *        perf(Event side);                              // The counters for a side - nullptr if not open
+    void          perfClose(Event side = ALL);                   // Close and free the counters - not while that side is running
+    bool          execOpen(Event side, float T = 0.01F, int samples = 1024); // Record execution time against samples for the PUSH or POP calls - see below
+    Histogram2D * exec(Event side);                              // The record for a side - nullptr if not open
+    void          execClose(Event side = ALL);                   // Free the record - not while that side is running
+    bool          share(AtsShm *shm, const char *label = nullptr); // Move the chronos into a shared memory slot - nullptr to take back
+    static void   metrics(Metrics *m, Ats *const *ats, const char *const *streams, int n, bool summary = false); // All EVENTS as OpenMetrics
+    static bool   pool(Histogram *h, Ats *const *ats, int n, Event e); // One event of n instances merged into one histogram
+    bool          record(Recorder *r, const char *stream = nullptr); // Add all EVENTS to a recorder - false if it is full
+    void          unrecord(Recorder *r);                             // Take them out again - before share or destroying
+
+    void trace(std::FILE *f); // Push a line of tracing information to a stdio - not for the audio thread
+    bool traceOpen(int records = 1024);                          // Keep a record of each tracking update in a ring - see below
+    void traceClose();                                           // Free the ring - neither this nor open while push is running
+    int  traceDrain(TraceRecord *records, int max);              // Copy out up to max of the oldest records - returns the number
+    static void traceText(std::FILE *f, const TraceRecord *r);   // Print a record as a line of trace
 
-    void trace(std::FILE *f); // Push a line of tracing information to a stdio
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // MEDIA TIMESTAMPED PUSH AND POP
+    //
+    // Where the exact time of the first sample of a block is known (hardware or PTP timestamped media) the
+    // timed variants take that time directly, in ns on the clock source of that side (Chrono::nowNs() by default).  Each call is then an
+    // exact point for the rate and latency estimate, so the percentile filter over the call offsets is bypassed
+    // until the next untimed push or pop and tracking can start from the first few calls.  The optional sample
+    // index is the media position of the first sample.  A jump forward leaves silence (push) or skips output
+    // (pop) for the missing samples, and on push any overlap with samples already received is dropped.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // CLOCK SOURCES
+    //
+    // By default both sides use the process clock (Chrono::setClock).  setSource gives the PUSH or POP side its
+    // own clock, used for its call times and all of its chronos - the tracking chronos go with push.  The two
+    // sides are compared directly to estimate the latency, so the sources must share one time base and may only
+    // differ in how it is read, for example a cheap TSC read on one side and a syscall on the other.  Use
+    // setRateHint, not the clock, to account for two media clock domains.  Relative call times and the media
+    // times for pushTimed and popTimed are on the source of that side.  A nullptr source restores the default.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // CONSISTENT SNAPSHOT
+    //
+    // Copies all of the EVENTS chronos into chronos[EVENTS] as they stood between push calls and between pop
+    // calls, so the counts agree with each other.  The log-linear chronos need storage for ATS_CHRONO_POOL bins.
+    // Neither push nor pop ever waits on this, it simply retries, and returns false if no clean copy was had.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // OPENMETRICS
+    //
+    // metrics writes every event of n instances to m (see metrics.h) as one family per event, ats_push_exec_seconds
+    // for example, with an instance per stream labelled stream="name".  Histograms by default, or summaries of the
+    // quantiles to keep a large export small.  Each chrono is copied by snapshot first, so this is safe from any
+    // thread, and the caller ends the exposition with m->eof().
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // POOLING
+    //
+    // pool gives one event across n instances, such as POP_EXEC of all the streams on a core, as a single histogram.
+    // h takes the bins of the first and the rest are merged in (see Histogram::merge), exactly where they share a
+    // config and rebinned where not.  Each chrono is copied by snapshot first, so this is safe from any thread.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // RECORDING
+    //
+    // record adds every event chrono to a Recorder (see record.h) under the same names as metrics, prefixed with
+    // "stream." when a stream is given, so UNDER_RUN, POP_EXEC and LATENCY can be looked back over after a glitch.
+    // The recorder holds the chronos by pointer, and share moves them, so record after share and unrecord before
+    // share or destroying the instance.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // SHARED MEMORY
+    //
+    // share moves the chronos, as they stand, into a free slot of an AtsShm made with create (see ats_shm.h) so
+    // another process can watch them, and share(nullptr) brings them back.  Nothing changes in push or pop, which
+    // reach the chronos through the same pointer either way.  As with config, do not call it while push or pop
+    // is running.  It returns false, leaving the chronos where they were, if there is no free slot or the copy is
+    // not clean.  The chronos in the slot hold no pointers of this process, so while shared they have no clock
+    // source of their own - push and pop pass the times in from setSource - and the time accessors read without
+    // a time use the process clock.  The instance is unshared when destroyed, and must be before the AtsShm is
+    // closed.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // BINARY TRACE
+    //
+    // trace formats the state with stdio and filters both offsets again, so it is for occasional use off the audio
+    // thread.  traceOpen instead has each tracking update in push write a TraceRecord into a lock free ring, which
+    // costs a copy of the values the update already has.  One other thread drains the ring, oldest first, and can
+    // write the records to a file for the ats_trace tool or print them with traceText.  When the ring is full new
+    // records are dropped, leaving a gap in the index, so push never waits.  The ring size is rounded up to a power of 2.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // HARDWARE COUNTERS
+    //
+    // perfOpen opens the Linux perf counters (see perf.h) for the thread that calls it, which should be the one
+    // making the push or pop calls, and from then on the counts across each call of that side are held in the
+    // chronos of perf(side).  It allocates and makes system calls, so call it once from that thread before the
+    // calls begin or as the first thing in one.  It returns false with nothing held where perf is not available.
+    // The counters are read at the same point as the execution time and follow chronoSample, so they are off
+    // with ATS_NO_CHRONOS.  Each read is a system call of most of a microsecond, half of which lands in the
+    // execution time, so this is for diagnosis rather than left running.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // EXECUTION TIME AGAINST SAMPLES
+    //
+    // The EXEC chronos mix calls of every size, so a slow call may just be a long one.  execOpen keeps a Histogram2D
+    // for a side of the execution time of each call, in seconds up to T, against the samples it handled, up to
+    // samples, both on log axes.  It costs a bin and five sums per call on top of the EXEC chrono, follows
+    // chronoSample as that does, and allocates, so open it before the calls begin.  marginal gives the time for a
+    // band of call sizes as a Histogram, and correlation shows how much of the spread the size accounts for.
 
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Versions
@@ -228,8 +402,8 @@ class Ats
     static const char * versionFull();
 
   private:
-    void atsTrack(); // Execute a tracking update - called in Pop
-    char mData[10544];
+    void atsTrack(uint64_t now); // Execute a tracking update - called in Push with the time of the call
+    char mData[15040 + ATS_STAGE_EVENTS * (sizeof(Chrono) + 160 * 4 + 8)];
     // @Alan - is there a convenient way of doing this without exposing struct?
     // Note that the config has an assert to ensure this is correct size
 };
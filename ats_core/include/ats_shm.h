@@ -0,0 +1,139 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// ats_shm.h
+//
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SHARED MEMORY EXPORT
+//
+// An AtsShm is a named POSIX shared memory region holding a header and a fixed number of slots.  Ats::share moves
+// the chronos of an instance, with their log-linear bins, into a slot, and from then on push and pop update them
+// there directly, so a monitor in another process can map the region and read the histograms with no system call,
+// lock or copy on the audio path.  The monitor opens the region read only and uses snapshot, which takes the
+// seqlock copy of each chrono of a slot in turn, so each histogram is self consistent but not one epoch.
+//
+// The layout is fixed by this header and checked on open by the version and the sizes it records, so both sides
+// must be built with the same ATS_BUFFER_SIZE and ATS_STAGE_TIMING.  create fails while another live process holds
+// the name, and only replaces a region whose creator has gone (or this process), so use one name per producing
+// process and unlink to clear anything else.  Keep the AtsShm open while any Ats is shared into it.
+//
+#pragma once
+#include "ats.h"
+#include <stdint.h>
+
+namespace Audinate { namespace ats {
+
+#define ATS_SHM_MAGIC   (0x4D535441) // "ATSM" in memory order
+#define ATS_SHM_VERSION (2)          // Bump with any change to the layout below
+
+typedef struct AtsShmHeader
+{
+    uint32_t magic;       // ATS_SHM_MAGIC
+    uint32_t version;     // ATS_SHM_VERSION
+    uint32_t headerSize;  // sizeof(AtsShmHeader) - the slots follow
+    uint32_t slotSize;    // sizeof(AtsShmSlot)
+    uint32_t slots;       // Number of slots
+    uint32_t events;      // Chronos in each slot (EVENTS)
+    uint32_t chronoSize;  // sizeof(Chrono)
+    uint32_t poolBins;    // Log-linear bins in each slot (ATS_CHRONO_POOL)
+    uint32_t pid;         // The creating process - create only takes over a region once it has gone
+    uint32_t reserved[7]; // Zero - pads the header to a cache line
+} AtsShmHeader;
+
+struct alignas(64) AtsShmSlot
+{
+    uint32_t state;                 // Low 2 bits 0 free, 1 being filled, 2 live - the count above shows reuse
+    uint32_t reserved;              // Zero
+    char     label[64];             // Label given to Ats::share
+    Chrono   chrono[EVENTS];        // The chronos of the instance, updated in place
+    uint32_t pool[ATS_CHRONO_POOL]; // Their log-linear bins - referenced by offset from each chrono
+};
+
+struct shm_t; // Abstract the implementation
+
+class AtsShm
+{
+  public:
+    AtsShm();
+    ~AtsShm();
+
+    bool create(const char *name, int slots = 64); // Create a fresh region to share into - name as for shm_open, e.g. "/ats" - false if held by a live process
+    bool open(const char *name);                   // Map an existing region read only to monitor it
+    void close();                                  // Unmap - unshare any Ats using it first
+    static bool unlink(const char *name);          // Remove the name - mappings stay valid until closed
+
+    const AtsShmHeader *header(); // The mapped header - nullptr if not open
+    int                 slots();  // Number of slots - 0 if not open
+
+    // Copy the chronos of a live slot into chronos[EVENTS], with their log-linear bins in storage, and the label
+    // into label[64] if given.  False if the slot is not live, is reused during the copy, or a chrono stays busy.
+    // The copies have no clock source, so sinceNs and sourceNs without a time read the clock of this process.
+    bool snapshot(int slot, Chrono *chronos, uint32_t *storage, int storageBins = ATS_CHRONO_POOL, char *label = nullptr, int tries = 100);
+
+  private:
+    friend class Ats;
+    AtsShmSlot *claim(const char *label); // Take a free slot for filling - nullptr if none
+    void        publish(AtsShmSlot *slot); // Mark a filled slot live
+    void        release(AtsShmSlot *slot); // Free a slot
+    char        mData[8 + 8 + 4 + 4];
+    // Note that the constructor has an assert to ensure this is correct size
+};
+
+}} // namespace Audinate::ats
+
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
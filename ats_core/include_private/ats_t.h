@@ -68,6 +68,7 @@
 //
 
 #include "ats.h"
+#include "ats_shm.h"
 #include <stdint.h>
 
 namespace Audinate { namespace ats {
@@ -79,7 +80,7 @@ typedef uint32_t ats_4f28u; // This is an unsigned 4.28 representation for the i
 inline ats_4f28u ats_4f28u_frac(ats_4f28u a) { return a & 0x0FFFFFFF; };
 inline int       ats_4f28u_int(ats_4f28u a) { return a >> 28; };
 inline ats_4f28u ats_float_4f28u(float f) { return (uint32_t)(f * (float)0x10000000); };
-inline ats_4f28u ats_double_4f28u(float f) { return (uint32_t)(f * (double)0x10000000); };
+inline ats_4f28u ats_double_4f28u(double f) { return (uint32_t)(f * (double)0x10000000 + 0.5); };
 inline float     ats_4f28u_float(ats_4f28u f) { return ((float)f) / (float)0x10000000; };
 inline ats_4f28u ats_4f28u_one() { return 0x10000000; };
 inline int       ats_4f28u_advance(ats_4f28u f, ats_4f28u s, int n)
@@ -90,6 +91,12 @@ inline int       ats_4f28u_advance(ats_4f28u f, ats_4f28u s, int n)
 
 #define ATS_Offsets ((uint32_t)512)
 
+#ifdef ATS_NO_CHRONOS
+#define ATS_CHRONO(x)    // Instrumentation compiled out - TRACK is always kept as it paces the control loop
+#else
+#define ATS_CHRONO(x) x
+#endif
+
 struct ats_t
 {
     Config    config;  // Everything in the config is considered stable after a setup
@@ -99,25 +106,67 @@ struct ats_t
     ats_4f28u outF;    // Fractional part of next output sample
     ats_4f28u step;    // Sample step - 4.28 fixed point   Ratio of input to output sample rate
 
-    Chrono chrono[Event::EVENTS]; // Set of statistic structures - null is disabled
+    Chrono *  chrono;                          // Set of statistic structures - chronoLocal or a shared memory slot
+    uint32_t *chronoPool;                      // Storage for the chronos needing more than the inline bins - with chrono
+    Chrono    chronoLocal[Event::EVENTS];      // The chronos when not shared
+    uint32_t  chronoPoolLocal[ATS_CHRONO_POOL];
+    AtsShm *  shm;                             // Region the chronos are shared into - nullptr if local
+    AtsShmSlot *shmSlot;                       // Slot in that region holding them
+    uint32_t pushSeq, popSeq;             // Odd while a push or pop is updating its chronos - for a consistent snapshot
+    ChronoSource pushSource, popSource;   // Clock for each side - nullptr for the process clock
+    void *       pushContext, *popContext;
+    Perf *       pushPerf, *popPerf;          // Hardware counters for each side - nullptr if not open
+    Histogram2D *pushExec, *popExec;          // Execution time against samples for each side - nullptr if not open
+
+    TraceRecord *traceRing;           // Records of the tracking updates - nullptr if not open
+    uint32_t     traceSize;           // Records in the ring - a power of 2
+    uint32_t     traceHead;           // Next record to write - only push moves this
+    uint32_t     traceTail;           // Next record to drain - only the drain moves this
+    uint32_t     traceIndex;          // Tracking updates so far
+    uint32_t     trackPush, trackPop; // Filtered offsets used by the last tracking update
+#ifdef ATS_STAGE_TIMING
+    ChronoSource stageSource; // Cycle counter for the stage timing where there is one
+#endif
 
     int32_t   maxIntDivT; // The (approximate) number of sample periods in 2^32 ns - used to calculate offset invariant
     float     trackInt;   // The accumulated  term for changing rate PPM relative to outrate/inrate
     float     trackProp;  // The proportional term for correcting rate PPM relative to outrate/inrate
     float     trackOff;   // The target rate offset from control PI controller in PPM relative to outrate/inrate
     float     trackSlew;  // The slew rate limited applied offset PPM relative to outrate/inrate
-    ats_4f28u trackStep0; // The nominal step of input samples for each output sample for outrate/inrate
+    ats_4f28u trackStep0; // The nominal step of input samples for each output sample for outrate/inrate (with any hint)
+    ats_4f28u trackStepN; // The nominal step for outrate/inrate before any rate hint
+    float     trackHint;  // The external rate hint applied to trackStep0 in PPM (hint scaled by confidence)
     float     trackT;     // The average period in the tracking loop
 
+    int32_t fixKp, fixKi, fixRate;   // Fixed point gains for ATS_TRACKING_FIXED - scaling is set out in ats_fixed.cpp
+    int32_t fixWarp, fixWarpInv;     // Warp in Q8 samples and the reciprocal used for the quadratic region
+    int32_t fixT;                    // The average period in the tracking loop in 1024ns units
+    int32_t fixProp, fixInt, fixOff; // Proportional, integral and target offset in Q16 ppm
+    int32_t fixSlew;                 // Slew rate limited applied offset in Q16 ppm
+    int32_t fixInNs, fixOutNs;       // Input and output rates in Q40 samples per ns - the call jitter without a divide
+    int32_t fixJitter, fixJitterInv; // filterJitter in Q8 samples and the reciprocal used to adapt the offset filters
+
     uint32_t pushOffsetN, popOffsetN; // Count of the push or pop (mod 2^32) and position index (mod )
     uint32_t pushOffset[ATS_Offsets]; // Atomic invariant being a time offset position in the buffer
     uint32_t popOffset[ATS_Offsets];  // (difference in sample point and scaled wall clock) represented as 0..2^32
+    float    pushJitter, popJitter;   // Smoothed absolute call jitter in samples - drives the adaptive filter windows
+    int32_t  fixPushJitter, fixPopJitter; // The same in Q8 samples for ATS_TRACKING_FIXED
+    uint32_t pushExact, popExact;     // Offset from the latest media timestamped push or pop - exact so not filtered
+    uint32_t pushExactN, popExactN;   // Count of timestamped calls since the last untimed call or reset
+    int64_t  pushIndex, popIndex;     // Next expected media sample index - negative until known
+    uint32_t pushPhase, popPhase;     // Calls to go until the next sampled chrono update when chronoSample > 1
         
     AtsData *data; // The working audio buffers
 };
 
 uint32_t atsPushOffset(ats_t *p);
 uint32_t atsPopOffset(ats_t *p);
+float    atsLatency(ats_t *p);
+float    atsOffsetLatency(ats_t *p, uint32_t push, uint32_t pop);
+void     atsTrackFloat(ats_t *p, int64_t diffNs, uint64_t now); // now stamps the value chronos
+void     atsTrackFixedConfig(ats_t *p);
+void     atsTrackFixed(ats_t *p, int64_t diffNs, uint64_t now);
+void     atsTraceWrite(ats_t *p, uint64_t now);
 
 }} // namespace Audinate::ats
 
@@ -56,6 +56,7 @@
 //
 
 #include "ats.h"
+#include "ats_shm.h"
 #include "ats_t.h"
 #include "versions.h"
 
@@ -66,6 +67,7 @@
 #endif
 
 #include <assert.h>
+#include <atomic>
 #include <float.h>
 #include <iostream>
 #include <math.h>
@@ -92,6 +94,9 @@ Ats::Ats()
         std::cout << "Insufficient ATS mData - Need " << sizeof(ats_t) << std::endl;
     assert(sizeof(mData) >= sizeof(ats_t)); // Ensure hidden data allocation is sufficient
     memset(mData, 0, sizeof(ats_t));
+    ats_t *p      = (ats_t *)mData;
+    p->chrono     = p->chronoLocal;
+    p->chronoPool = p->chronoPoolLocal;
 }
 
 Ats::~Ats()
@@ -99,6 +104,10 @@ Ats::~Ats()
     ats_t *p = (ats_t *)mData;
     if (p->data != nullptr)
         free(p->data);
+    perfClose();
+    execClose();
+    traceClose();
+    share(nullptr);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -127,6 +136,247 @@ bool Ats::setRate(double rate)
     return true;
 }
 
+// The hint seeds the nominal step directly, so the integrator no longer has to find the offset.  Confidence
+// sets how much of the hint is used.  Only the change in the scaled hint moves, out of the learnt integral
+// and into the nominal step, so the applied rate is held and a repeated hint is a no op.  The applied offset
+// jumps straight to the new operating point rather than slewing, as the hint is the better estimate of
+// where it should be.  Like setDepth this is not synchronized with push, so call it from that thread.
+bool Ats::setRateHint(float ppm, float confidence)
+{
+    ats_t *p = (ats_t *)mData;
+    if (p->configs == 0)
+        return false;
+    if (confidence < 0.0F)
+        confidence = 0.0F;
+    if (confidence > 1.0F)
+        confidence = 1.0F;
+
+    float delta = ppm * confidence - p->trackHint; // The slewed offset comes off the nominal step, so the integral gains the change
+    if (delta == 0.0F)
+        return true;
+    p->trackHint  = ppm * confidence;
+    p->trackStep0 = p->trackStepN + (int)(p->trackHint / 1E6F * p->trackStepN + 0.5);
+
+    p->trackInt  += delta;
+    p->trackOff   = p->trackProp + p->trackInt;
+    p->trackSlew  = p->trackOff;
+    p->fixInt    += (int32_t)(delta * 65536.0F + (delta < 0 ? -0.5F : 0.5F));
+    p->fixOff     = p->fixProp + p->fixInt;
+    p->fixSlew    = p->fixOff;
+
+    float slew = (p->config.mode & ATS_TRACKING_FIXED) ? p->fixSlew / 65536.0F : p->trackSlew;
+    p->step    = p->trackStep0 - (int)(slew / 1E6F * p->trackStep0 + 0.5);
+    return true;
+}
+
+bool Ats::setSource(Event side, ChronoSource source, void *context)
+{
+    static const Event pushSide[] = { PUSH, PUSH_RATE, PUSH_EXEC, OFFSET, DEPTH, LATENCY, TRACK };
+    static const Event popSide[]  = { POP, POP_RATE, POP_EXEC, UNDER_RUN, UNDER_RUN_SIZE };
+    ats_t *p = (ats_t *)mData;
+    if (side == PUSH) {
+        p->pushContext = context;
+        p->pushSource  = source;
+    } else if (side == POP) {
+        p->popContext = context;
+        p->popSource  = source;
+    } else
+        return false;
+    if (p->shm != nullptr) // Shared chronos never hold a pointer of this process - push and pop pass the times in
+        return true;
+    if (side == PUSH)
+        for (Event e : pushSide)
+            p->chrono[e].setSource(source, context);
+    else
+        for (Event e : popSide)
+            p->chrono[e].setSource(source, context);
+    return true;
+}
+
+bool Ats::perfOpen(Event side)
+{
+    ats_t *p    = (ats_t *)mData;
+    Perf **perf = side == PUSH ? &p->pushPerf : side == POP ? &p->popPerf : nullptr;
+    if (perf == nullptr)
+        return false;
+    if (*perf == nullptr)
+        *perf = new Perf();
+    if (!(*perf)->open(side == PUSH ? "PUSH" : "POP")) {
+        perfClose(side);
+        return false;
+    }
+    return true;
+}
+
+Perf *Ats::perf(Event side)
+{
+    ats_t *p = (ats_t *)mData;
+    return side == PUSH ? p->pushPerf : side == POP ? p->popPerf : nullptr;
+}
+
+void Ats::perfClose(Event side)
+{
+    ats_t *p = (ats_t *)mData;
+    if ((side == PUSH || side == ALL) && p->pushPerf != nullptr) {
+        delete p->pushPerf;
+        p->pushPerf = nullptr;
+    }
+    if ((side == POP || side == ALL) && p->popPerf != nullptr) {
+        delete p->popPerf;
+        p->popPerf = nullptr;
+    }
+}
+
+bool Ats::execOpen(Event side, float T, int samples)
+{
+    ats_t *       p    = (ats_t *)mData;
+    Histogram2D **exec = side == PUSH ? &p->pushExec : side == POP ? &p->popExec : nullptr;
+    if (exec == nullptr || samples < 2)
+        return false;
+    Histogram2D *h = *exec != nullptr ? *exec : new Histogram2D();
+    if (!h->config(1, (float)samples, ATS_EXEC_SAMPLE_BINS, COUNTER | LOGX, 1E-8F, T, ATS_EXEC_TIME_BINS, DITHER | LOGX, side == PUSH ? "PUSH EXEC" : "POP EXEC")) {
+        if (*exec == nullptr)
+            delete h;
+        return false;
+    }
+    *exec = h;
+    return true;
+}
+
+Histogram2D *Ats::exec(Event side)
+{
+    ats_t *p = (ats_t *)mData;
+    return side == PUSH ? p->pushExec : side == POP ? p->popExec : nullptr;
+}
+
+void Ats::execClose(Event side)
+{
+    ats_t *p = (ats_t *)mData;
+    if ((side == PUSH || side == ALL) && p->pushExec != nullptr) {
+        delete p->pushExec;
+        p->pushExec = nullptr;
+    }
+    if ((side == POP || side == ALL) && p->popExec != nullptr) {
+        delete p->popExec;
+        p->popExec = nullptr;
+    }
+}
+
+// The chronos move by snapshot, which copies each with its log-linear bins into the new pool and points it there
+bool Ats::share(AtsShm *shm, const char *label)
+{
+    ats_t *     p    = (ats_t *)mData;
+    Chrono *    to   = p->chronoLocal;
+    uint32_t *  pool = p->chronoPoolLocal;
+    AtsShmSlot *slot = nullptr;
+    if (shm != nullptr) {
+        slot = shm->claim(label);
+        if (slot == nullptr)
+            return false;
+        to   = slot->chrono;
+        pool = slot->pool;
+    } else if (p->shm == nullptr)
+        return true; // Already local
+
+    if (!snapshot(to, pool, ATS_CHRONO_POOL)) { // The writer kept it busy - leave the chronos where they are
+        if (slot != nullptr)
+            shm->release(slot);
+        return false;
+    }
+    if (shm != nullptr)
+        for (int n = 0; n < EVENTS; n++)
+            to[n].setSource(); // No pointers into this process in the slot
+    p->chrono     = to;
+    p->chronoPool = pool;
+    if (p->shm != nullptr)
+        p->shm->release(p->shmSlot);
+    p->shm     = shm;
+    p->shmSlot = slot;
+    if (shm != nullptr)
+        shm->publish(slot);
+    else { // Back home, so the chronos take the sources again
+        setSource(PUSH, p->pushSource, p->pushContext);
+        setSource(POP, p->popSource, p->popContext);
+    }
+    return true;
+}
+
+struct AtsMetric
+{
+    const char *name, *unit, *help;
+};
+
+static const AtsMetric atsMetric[EVENTS] = {
+    { "ats_push_interval_seconds", "seconds", "Time between push calls" },
+    { "ats_push_sample_period_seconds", "seconds", "Audio sample period seen by push" },
+    { "ats_push_exec_seconds", "seconds", "Execution time of push" },
+    { "ats_pop_interval_seconds", "seconds", "Time between pop calls" },
+    { "ats_pop_sample_period_seconds", "seconds", "Audio sample period seen by pop" },
+    { "ats_pop_exec_seconds", "seconds", "Execution time of pop" },
+    { "ats_under_run_interval_seconds", "seconds", "Time between under runs" },
+    { "ats_under_run_size_samples", "samples", "Samples short in each under run" },
+    { "ats_rate_offset_ppm", "ppm", "Control rate offset from the configured rate" },
+    { "ats_depth_samples", "samples", "Buffer depth at each tracking update" },
+    { "ats_latency_samples", "samples", "Latency estimate at each tracking update" },
+    { "ats_track_interval_seconds", "seconds", "Time between tracking updates" },
+#ifdef ATS_STAGE_TIMING
+    { "ats_push_stage_offset_seconds", "seconds", "Push offset bookkeeping" },
+    { "ats_push_stage_track_seconds", "seconds", "Push tracking update" },
+    { "ats_push_stage_data_seconds", "seconds", "Push copy into the ring" },
+    { "ats_pop_stage_offset_seconds", "seconds", "Pop offset bookkeeping and under run check" },
+    { "ats_pop_stage_interp_seconds", "seconds", "Pop interpolation" },
+    { "ats_pop_stage_convert_seconds", "seconds", "Pop int32 conversion" },
+#endif
+};
+
+void Ats::metrics(Metrics *m, Ats *const *ats, const char *const *streams, int n, bool summary)
+{
+    for (int e = 0; e < EVENTS; e++) {
+        m->family(atsMetric[e].name, summary ? "summary" : "histogram", atsMetric[e].help, atsMetric[e].unit);
+        for (int k = 0; k < n; k++) {
+            char labels[160] = "";
+            if (streams != nullptr && streams[k] != nullptr)
+                Metrics::label(labels, sizeof(labels), "stream", streams[k]);
+            if (summary)
+                m->summary(atsMetric[e].name, ats[k]->chrono((Event)e), labels);
+            else
+                m->histogram(atsMetric[e].name, ats[k]->chrono((Event)e), labels);
+        }
+    }
+}
+
+bool Ats::pool(Histogram *h, Ats *const *ats, int n, Event e)
+{
+    Chrono    copy;
+    Histogram one;
+    uint32_t  storage[ATS_CHRONO_POOL];
+    for (int k = 0; k < n; k++) {
+        if (ats[k]->chrono(e)->snapshot(&copy, storage, ATS_CHRONO_POOL) < 0)
+            return false;
+        copy.histogram(k == 0 ? h : &one);
+        if (k > 0 && !h->merge(&one))
+            return false;
+    }
+    return n > 0;
+}
+
+bool Ats::record(Recorder *r, const char *stream)
+{
+    for (int e = 0; e < EVENTS; e++) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s%s%s", stream ? stream : "", stream ? "." : "", atsMetric[e].name);
+        if (!r->add(chrono((Event)e), name))
+            return false;
+    }
+    return true;
+}
+
+void Ats::unrecord(Recorder *r)
+{
+    for (int e = 0; e < EVENTS; e++)
+        r->remove(chrono((Event)e));
+}
+
 uint32_t kth_smallest(uint32_t a[], int n, int k)
 {
     int      i, j, l, m;
@@ -161,35 +411,105 @@ uint32_t kth_smallest(uint32_t a[], int n, int k)
     else return 0;
 }
 
-// Get the set of useful 
-uint32_t atsPushOffset(ats_t *p)
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// OFFSET FILTERS
+//
+// The push and pop offsets are de-jittered by taking an upper percentile over a window of recent calls, as
+// late calls push the invariant down.  The window and percentile adapt to the measured call jitter.  A quiet
+// link uses a short window and a median that follows drift quickly, whereas a bursty link stretches out to
+// the configured maximum window and the 90th percentile to reject the late calls.  The ring is always sized
+// to that maximum so the adaption can move freely without losing history.  With ATS_TRACKING_FIXED the jitter is
+// kept in Q8 samples and the adaption in Q16, so there is no float per call.
+//
+
+inline float atsJitter(float jitter, int64_t diffNs, int samples, float rate) // Smooth the call jitter in samples
 {
-    uint32_t tmp[p->config.filterPush];
-    int use = std::min(p->config.filterPush, p->pushOffsetN);
-    if (use==0)  return p->in << (32 - ATS_BUFFER_SIZE_LOG2);
+    float err = fabsf((float)diffNs * 1E-9F * rate - (float)samples);
+    return jitter + (err - jitter) * (1.0F / 16.0F);
+}
 
-    uint32_t offset = p->pushOffset[(p->pushOffsetN-1) % p->config.filterPush];
-    for (int n = 0; n < use; n++) tmp[n] = p->pushOffset[n] - offset - (1 << 31);
-    return kth_smallest(tmp, use, use - use/10 - 1) + offset + (1 << 31);
+inline int32_t atsJitterFixed(int32_t jitter, int64_t diffNs, int samples, int32_t rateNs) // The same in Q8 samples
+{
+    if (diffNs > ((int64_t)1 << 32)) // Around 4s - a stall rather than jitter, and keeps the product in range
+        diffNs = (int64_t)1 << 32;
+    int32_t err = (int32_t)((diffNs * rateNs + ((int64_t)1 << 31)) >> 32) - samples * 256;
+    if (err < 0)
+        err = -err;
+    return jitter + ((err - jitter + 8) >> 4);
 }
 
-uint32_t atsPopOffset(ats_t *p)
+inline void atsJitterUpdate(ats_t *p, int call, int64_t diffNs, int samples)
 {
-    uint32_t tmp[p->config.filterPop];
-    int use = std::min(p->config.filterPop, p->popOffsetN);
-    if (use==0)  return p->outN << (32 - ATS_BUFFER_SIZE_LOG2);
+    if (p->config.filterMin == 0) // Fixed filter windows - the jitter is not used
+        return;
+    if (p->config.mode & ATS_TRACKING_FIXED) {
+        if (call == PUSH)
+            p->fixPushJitter = atsJitterFixed(p->fixPushJitter, diffNs, samples, p->fixInNs);
+        else
+            p->fixPopJitter = atsJitterFixed(p->fixPopJitter, diffNs, samples, p->fixOutNs);
+    } else {
+        if (call == PUSH)
+            p->pushJitter = atsJitter(p->pushJitter, diffNs, samples, p->config.inRate);
+        else
+            p->popJitter = atsJitter(p->popJitter, diffNs, samples, p->config.outRate);
+    }
+}
+
+uint32_t atsFilterOffset(const ats_t *p, const uint32_t *ring, uint32_t count, uint32_t size, float jitter, int32_t fixJitter)
+{
+    uint32_t tmp[ATS_Offsets];
+    uint32_t window = size;
+    int      use, k;
+    if (p->config.mode & ATS_TRACKING_FIXED) {
+        int32_t adapt = 65536; // Q16 - as below
+        if (p->config.filterMin > 0 && p->config.filterMin < size) {
+            if (p->fixJitterInv > 0)
+                adapt = (int32_t)std::min((int64_t)65536, ((int64_t)fixJitter * p->fixJitterInv) >> 16);
+            window = p->config.filterMin + (uint32_t)(((int64_t)(size - p->config.filterMin) * adapt) >> 16);
+        }
+        use = (int)std::min(window, count);
+        k   = use - 1 - (int)(((int64_t)use * (32768 - ((26215 * (int64_t)adapt) >> 16))) >> 16); // 0.5 - 0.4 adapt, 0.4 rounded up to land as the float does
+    } else {
+        float adapt = 1.0F; // 0 for a quiet link through to 1 at or above the configured jitter
+        if (p->config.filterMin > 0 && p->config.filterMin < size) {
+            adapt  = p->config.filterJitter > 0 ? std::min(1.0F, jitter / p->config.filterJitter) : 1.0F;
+            window = p->config.filterMin + (uint32_t)((float)(size - p->config.filterMin) * adapt);
+        }
+        use = (int)std::min(window, count);
+        k   = use - 1 - (int)((float)use * (0.5F - 0.4F * adapt));
+    }
+
+    uint32_t offset = ring[(count - 1) % size]; // Work relative to the latest entry to handle wrapping
+    for (int n = 0; n < use; n++)
+        tmp[n] = ring[(count - 1 - n) % size] - offset - (1 << 31);
+    return kth_smallest(tmp, use, k) + offset + (1 << 31);
+}
 
-    uint32_t offset = p->popOffset[(p->popOffsetN-1) % p->config.filterPop];
-    for (int n = 0; n < use; n++) if (p->popOffset[n]) tmp[n] = p->popOffset[n] - offset - (1 << 31);
-    return kth_smallest(tmp, use, use - use/10 - 1) + offset + (1 << 31);
+uint32_t atsPushOffset(ats_t *p)
+{
+    if (p->pushExactN > 0)
+        return p->pushExact;
+    if (p->config.filterPush == 0 || p->pushOffsetN == 0)
+        return p->in << (32 - ATS_BUFFER_SIZE_LOG2);
+    return atsFilterOffset(p, p->pushOffset, p->pushOffsetN, p->config.filterPush, p->pushJitter, p->fixPushJitter);
+}
+
+uint32_t atsPopOffset(ats_t *p)
+{
+    if (p->popExactN > 0)
+        return p->popExact;
+    if (p->config.filterPop == 0 || p->popOffsetN == 0)
+        return p->outN << (32 - ATS_BUFFER_SIZE_LOG2);
+    return atsFilterOffset(p, p->popOffset, p->popOffsetN, p->config.filterPop, p->popJitter, p->fixPopJitter);
 }
 
 // Latency uses a bit more information to estimate, includes outlier removal (late calls) and relies on some estimate of period
-float Ats::getLatency()
+float atsLatency(ats_t *p) { return atsOffsetLatency(p, atsPushOffset(p), atsPopOffset(p)); }
+
+float atsOffsetLatency(ats_t *p, uint32_t push, uint32_t pop)
 {
-    ats_t *p       = (ats_t *)mData;
     float  latency = 0;
-    int    offset  = atsPushOffset(p) - atsPopOffset(p); // Note that this is a wrapping int
+    int    offset  = push - pop; // Note that this is a wrapping int
     latency        = (float)offset * (float)ATS_BUFFER_SIZE / 4294967296.0F;
     if (latency < -1 * p->config.bufferSamples / 4)
         latency += p->config.bufferSamples;
@@ -198,6 +518,8 @@ float Ats::getLatency()
     return latency;
 }
 
+float Ats::getLatency() { return atsLatency((ats_t *)mData); }
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // SIMPLE ACCESS TO THE chrono
 //
@@ -222,9 +544,41 @@ void Ats::chronoReset(Event index)
     p->chrono[index].reset();
 }
 
-void Ats::chronoDefault(int bins, float T)
+// The log-linear chronos hold a wide range at fixed relative precision, so take their bins from the pool
+void atsChronoLogLin(ats_t *p, int *used, Event e, float lowest, float highest, HistFlag flags, const char *name)
+{
+    int bins = std::min(Chrono::logLinBins(lowest, highest, 1, flags), (int)ATS_CHRONO_POOL - *used);
+    p->chrono[e].configLogLin(lowest, highest, 1, flags, name, p->chronoPool + *used, bins);
+    *used += bins;
+}
+
+bool Ats::snapshot(Chrono *chronos, uint32_t *storage, int storageBins, int tries)
 {
     ats_t *p = (ats_t *)mData;
+    for (; tries > 0; tries--) {
+        uint32_t push = *(volatile uint32_t *)&p->pushSeq;
+        uint32_t pop  = *(volatile uint32_t *)&p->popSeq;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((push | pop) & 1)
+            continue;
+        int used = 0, n;
+        for (n = 0; n < EVENTS; n++) {
+            int bins = p->chrono[n].snapshot(&chronos[n], storage + used, storageBins - used, 1);
+            if (bins < 0)
+                break;
+            used += bins;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (n == EVENTS && *(volatile uint32_t *)&p->pushSeq == push && *(volatile uint32_t *)&p->popSeq == pop)
+            return true;
+    }
+    return false;
+}
+
+void Ats::chronoDefault(int bins, float T)
+{
+    ats_t *p    = (ats_t *)mData;
+    int    pool = 0;
     // Use the atsChrono method here as it will make the chrono if it does not exist
     this->chrono(PUSH)->config(0.000F, T, bins, DITHER,
                                "PUSH FUNCTION CALL PERIOD (s)"); // Expecting block calls <10ms
@@ -234,10 +588,18 @@ void Ats::chronoDefault(int bins, float T)
     this->chrono(POP_RATE)->config (0, 5.0F/p->config.outRate,bins, DITHER, "POP AUDIO RAW PERIOD (s)"); 
     this->chrono(UNDER_RUN)->config(0.001F, 1000.0F, bins, DITHER | LOGX,
                                     "TIME BETWEEN UNDERRUNS (s)"); // 10s range
-    this->chrono(UNDER_RUN_SIZE)->config(10, 1000, bins, DITHER | LOGX | COUNTER,
-                                         "UNDER RUN SIZE (samples)"); // Up to 200 samples or nearly 5ms
-    this->chrono(PUSH_EXEC)->config(0, T, bins, DITHER, "EXECUTION TIME OF PUSH (s)");
-    this->chrono(POP_EXEC)->config(0, T, bins, DITHER, "EXECUTION TIME OF POP (s)");
+    atsChronoLogLin(p, &pool, UNDER_RUN_SIZE, 1, 1000, COUNTER, "UNDER RUN SIZE (samples)"); // Exact to 32 samples then 1 digit
+    atsChronoLogLin(p, &pool, PUSH_EXEC, 10e-9F, T, NONE, "EXECUTION TIME OF PUSH (s)");   // 8ns units up to 256ns then 1 digit
+    atsChronoLogLin(p, &pool, POP_EXEC, 10e-9F, T, NONE, "EXECUTION TIME OF POP (s)");
+#ifdef ATS_STAGE_TIMING
+    atsChronoLogLin(p, &pool, PUSH_OFFSET, 8e-9F, 50e-6F, NONE, "PUSH STAGE - OFFSETS (s)"); // 8ns units up to 256ns then 1 digit
+    atsChronoLogLin(p, &pool, PUSH_TRACK, 8e-9F, 50e-6F, NONE, "PUSH STAGE - TRACKING (s)");
+    atsChronoLogLin(p, &pool, PUSH_DATA, 8e-9F, 50e-6F, NONE, "PUSH STAGE - RING COPY (s)");
+    atsChronoLogLin(p, &pool, POP_OFFSET, 8e-9F, 50e-6F, NONE, "POP STAGE - OFFSETS (s)");
+    atsChronoLogLin(p, &pool, POP_INTERP, 8e-9F, 50e-6F, NONE, "POP STAGE - INTERPOLATION (s)");
+    atsChronoLogLin(p, &pool, POP_CONVERT, 8e-9F, 50e-6F, NONE, "POP STAGE - INT CONVERSION (s)");
+    p->stageSource = Chrono::source(TSC);
+#endif
     this->chrono(OFFSET)->config(-200, 200, bins, DITHER | COUNTER, "OFFSET FROM CONFIGURED RATE (ppm)");
     this->chrono(DEPTH)->config(0, 1000, bins, DITHER | COUNTER, "OBSERVED BUFFER DEPTH (input samples)");
     this->chrono(LATENCY)->config((float)(((ats_t *)mData)->config.trackTarget - 50), (float)(((ats_t *)mData)->config.trackTarget + 50), bins, DITHER | COUNTER, "ESTIMATED LATENCY (input samples)");
@@ -271,6 +633,9 @@ bool Ats::config(Config *config)
         mAts->trackProp = 0;
         mAts->trackInt  = 0;
         mAts->trackT    = 0;
+        mAts->fixProp   = 0;
+        mAts->fixInt    = 0;
+        mAts->fixT      = 0;
     }
 
     if (config->inRate <= 0)
@@ -278,7 +643,8 @@ bool Ats::config(Config *config)
     if (config->outRate <= 0)
         config->outRate = 1;
 
-    mAts->trackStep0 = ats_4f28u_one() + (int)((float)(config->inRate - config->outRate) / config->outRate * ats_4f28u_one() + 0.5);
+    mAts->trackStepN = ats_4f28u_one() + (int)((float)(config->inRate - config->outRate) / config->outRate * ats_4f28u_one() + 0.5);
+    mAts->trackStep0 = mAts->trackStepN + (int)(mAts->trackHint / 1E6F * mAts->trackStepN + 0.5); // Keep any hint across a config
     mAts->maxIntDivT = (int32_t)(4.294967296F * config->inRate * (1<<10));
     mAts->step       = mAts->trackStep0;
 
@@ -286,9 +652,18 @@ bool Ats::config(Config *config)
     config->filterPop  = std::min(config->filterPop,  ATS_Offsets);
     mAts->pushOffsetN = 0;
     mAts->popOffsetN  = 0;
+    mAts->pushJitter  = config->filterJitter; // Start wide and let the windows close in as the jitter settles
+    mAts->popJitter   = config->filterJitter;
+    mAts->pushExactN  = 0;
+    mAts->popExactN   = 0;
+    mAts->pushIndex   = -1;
+    mAts->popIndex    = -1;
+    mAts->pushPhase   = 0;
+    mAts->popPhase    = 0;
 
     memcpy(&mAts->config, config, sizeof(Config));
     mAts->configs++;
+    atsTrackFixedConfig(mAts);
 
     this->chronoDefault(101); // Setup the default ranges in the Chronographs
 
@@ -303,16 +678,30 @@ bool Ats::config(Config *config)
 // be called from the Push.
 //
 
-void Ats::atsTrack()
+void Ats::atsTrack(uint64_t now)
 {
     ats_t *p = (ats_t *)mData;
 
-    if (p->chrono[TRACK].sinceNs() < 10000000) return;                      // Throttle tracking calls
-    p->chrono[TRACK].event();
-    if (p->pushOffsetN<10 || p->popOffsetN<10) return;                      // Don't track if no information
+    if (p->chrono[TRACK].sinceNs(now) < 10000000) return;                   // Throttle tracking calls
+    p->chrono[TRACK].event(now);
+    if ((p->pushOffsetN<10 && p->pushExactN==0) ||
+        (p->popOffsetN<10  && p->popExactN==0)) return;                     // Don't track if no information
+
+    if (p->config.mode & ATS_TRACKING_FIXED)
+        atsTrackFixed(p, p->chrono[TRACK].diffNs(), now);
+    else
+        atsTrackFloat(p, p->chrono[TRACK].diffNs(), now);
+    p->traceIndex++;
+    if (p->traceRing != nullptr)
+        atsTraceWrite(p, now);
+}
 
-    p->trackT     = 0.5E-9F * p->chrono[TRACK].diffNs() + 0.5F * p->trackT; // Mild smoothing - used to calculate integration
-    float latency = getLatency();                                           // Latency
+void atsTrackFloat(ats_t *p, int64_t diffNs, uint64_t now)
+{
+    p->trackT     = 0.5E-9F * diffNs + 0.5F * p->trackT;                    // Mild smoothing - used to calculate integration
+    p->trackPush  = atsPushOffset(p);                                       // Kept for the trace
+    p->trackPop   = atsPopOffset(p);
+    float latency = atsOffsetLatency(p, p->trackPush, p->trackPop);         // Latency
     float error   = ((float)p->config.trackTarget - latency);               // Error in samples
 
     if (p->config.trackRange > 0) {
@@ -353,9 +742,10 @@ void Ats::atsTrack()
     // Update step for the new rate in ats_4f28u - adust in ppm about nominal rate
     p->step = p->trackStep0 - (int)(p->trackSlew / 1E6F * p->trackStep0 + 0.5);
 
-    p->chrono[LATENCY].count((int)(latency + 0.5));
-    p->chrono[DEPTH].count(getDepth());
-    p->chrono[OFFSET].count((int)(p->trackSlew + 0.5));
+    (void)now; // Only for the chronos, so unused with ATS_NO_CHRONOS
+    ATS_CHRONO(p->chrono[LATENCY].count((int)(latency + 0.5), 1, now)); // Stamped with the tracking time, so sinceNs and periodNs hold
+    ATS_CHRONO(p->chrono[DEPTH].count(SUB(p->in, p->outN), 1, now));
+    ATS_CHRONO(p->chrono[OFFSET].count((int)(p->trackSlew + 0.5), 1, now));
 }
 
 void Ats::trackReset() // Reset the tracking state (integrator) and bump from the current
@@ -363,6 +753,8 @@ void Ats::trackReset() // Reset the tracking state (integrator) and bump from th
     ats_t *p      = (ats_t *)mData;
     p->trackInt   = 0;
     p->trackSlew  = 0;
+    p->fixInt     = 0;
+    p->fixSlew    = 0;
     p->step       = p->trackStep0;
     // Give things the working space (target)
     p->outN       = MOD(p->in - p->config.trackTarget/2);
@@ -370,34 +762,230 @@ void Ats::trackReset() // Reset the tracking state (integrator) and bump from th
     p->chrono[TRACK].reset();
     p->pushOffsetN = 0;
     p->popOffsetN = 0;  
+    p->pushExactN = 0;
+    p->popExactN = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TRACE
+//
+// The ring is single producer (the tracking update in push) and single consumer (the drain).  Each side only
+// writes its own index, with a release after the record is written or read out and an acquire before the other
+// index is trusted.  Records are dropped rather than overwritten when full, so a drain part way through a
+// record never sees it change.
+//
+
+void atsTraceRecord(ats_t *p, uint64_t now, uint32_t push, uint32_t pop, TraceRecord *r)
+{
+    bool fixed      = p->config.mode & ATS_TRACKING_FIXED;
+    r->time         = now;
+    r->latency      = atsOffsetLatency(p, push, pop);
+    r->step         = p->step;
+    r->pushRaw      = p->config.filterPush ? p->pushOffset[(p->pushOffsetN - 1) % p->config.filterPush] : 0;
+    r->pushFiltered = push;
+    r->popRaw       = p->config.filterPop ? p->popOffset[(p->popOffsetN - 1) % p->config.filterPop] : 0;
+    r->popFiltered  = pop;
+    r->prop         = fixed ? p->fixProp * (1E3F / 65536.0F) : p->trackProp * 1E3F;
+    r->integral     = fixed ? p->fixInt  * (1E3F / 65536.0F) : p->trackInt  * 1E3F;
+    r->slew         = fixed ? p->fixSlew * (1E3F / 65536.0F) : p->trackSlew * 1E3F;
+    r->depth        = SUB(p->in, p->outN);
+    r->pushCount    = (uint32_t)p->chrono[PUSH].eventCount();
+    r->popCount     = (uint32_t)p->chrono[POP].eventCount();
+    r->index        = p->traceIndex;
+}
+
+void atsTraceWrite(ats_t *p, uint64_t now) // From the tracking update only
+{
+    uint32_t head = p->traceHead;
+    uint32_t tail = *(volatile uint32_t *)&p->traceTail;
+    std::atomic_thread_fence(std::memory_order_acquire); // The drain is done with anything before tail
+    if (head - tail >= p->traceSize)
+        return; // Full - the index shows the gap
+    atsTraceRecord(p, now, p->trackPush, p->trackPop, &p->traceRing[head & (p->traceSize - 1)]);
+    std::atomic_thread_fence(std::memory_order_release);
+    *(volatile uint32_t *)&p->traceHead = head + 1;
 }
 
 void Ats::trace(std::FILE *f)
 {
-    ats_t *p   = (ats_t *)mData;
-    double now = 1E-9 * Chrono::nowNs();
+    ats_t *     p = (ats_t *)mData;
+    TraceRecord r;
+    atsTraceRecord(p, Chrono::nowNs(), atsPushOffset(p), atsPopOffset(p), &r);
+    traceText(f, &r);
+}
+
+void Ats::traceText(std::FILE *f, const TraceRecord *r)
+{
     fprintf(
         f,
         "%11.3lf %8.2f %11.9lf %10u %10u %10u %10u %11.0f %11.0f %11.0f %6d %9d %9d\n",
-        now,                           // 1  TIME
-        getLatency(),                  // 2  LATENCY
-        getRate(),                     // 3  RATE
-        p->pushOffset[(p->pushOffsetN-1)%p->config.filterPush], // 4  LAST RAW PUSH OFFSET
-        atsPushOffset(p),              // 5  FILTERED PUSH OFFSET
-        p->popOffset[(p->popOffsetN-1)%p->config.filterPop],   // 6  LAST RAW POP OFFSET
-        atsPopOffset(p),               // 7  FILTERED POP OFFSET
-        p->trackProp * 1E3F,           // 8  PROPORTIONAL ADJUST ppb
-        p->trackInt * 1E3F,            // 9  INTEGRAL     ADJUST ppb
-        p->trackSlew * 1E3F,           // 10 SLEW LIMITED ADJUST ppb
-        getDepth(),                    // 11 BUFFER DEPTH
-        (int)p->chrono[PUSH].eventCount(),  // 12 PUSH EVENT
-        (int)p->chrono[POP].eventCount());  // 13 POP EVENT COUNT 
+        1E-9 * r->time,                   // 1  TIME
+        r->latency,                       // 2  LATENCY
+        (double)(0x10000000) / r->step,   // 3  RATE
+        r->pushRaw,                       // 4  LAST RAW PUSH OFFSET
+        r->pushFiltered,                  // 5  FILTERED PUSH OFFSET
+        r->popRaw,                        // 6  LAST RAW POP OFFSET
+        r->popFiltered,                   // 7  FILTERED POP OFFSET
+        r->prop,                          // 8  PROPORTIONAL ADJUST ppb
+        r->integral,                      // 9  INTEGRAL     ADJUST ppb
+        r->slew,                          // 10 SLEW LIMITED ADJUST ppb
+        r->depth,                         // 11 BUFFER DEPTH
+        (int)r->pushCount,                // 12 PUSH EVENT
+        (int)r->popCount);                // 13 POP EVENT COUNT
+}
+
+bool Ats::traceOpen(int records)
+{
+    ats_t *p = (ats_t *)mData;
+    traceClose();
+    uint32_t size = 1;
+    while (size < (uint32_t)records && size < 0x10000000)
+        size <<= 1;
+    p->traceRing = (TraceRecord *)malloc(size * sizeof(TraceRecord));
+    if (p->traceRing == nullptr)
+        return false;
+    p->traceSize = size;
+    p->traceHead = 0;
+    p->traceTail = 0;
+    return true;
+}
+
+void Ats::traceClose()
+{
+    ats_t *p = (ats_t *)mData;
+    if (p->traceRing != nullptr)
+        free(p->traceRing);
+    p->traceRing = nullptr;
+    p->traceSize = 0;
+}
+
+int Ats::traceDrain(TraceRecord *records, int max)
+{
+    ats_t *p = (ats_t *)mData;
+    if (p->traceRing == nullptr)
+        return 0;
+    uint32_t tail = p->traceTail;
+    uint32_t head = *(volatile uint32_t *)&p->traceHead;
+    std::atomic_thread_fence(std::memory_order_acquire); // Records before head are complete
+    int n = 0;
+    for (; n < max && tail != head; n++, tail++)
+        records[n] = p->traceRing[tail & (p->traceSize - 1)];
+    std::atomic_thread_fence(std::memory_order_release);
+    *(volatile uint32_t *)&p->traceTail = tail;
+    return n;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// CALL INSTRUMENTATION
+//
+// The call, rate and exec chronos for push (PUSH..PUSH_EXEC) and pop (POP..POP_EXEC) are consecutive, so one
+// pair of helpers covers both.  With chronoSample N > 1 a count down picks every Nth call to record with a
+// weight of N, and the call before restarts the intervals so the histograms still see a single period.
+//
+
+inline uint64_t atsNow(ChronoSource source, void *context) { return source ? source(context) : Chrono::nowNs(); }
+
+inline void atsSeqBegin(volatile uint32_t *seq) // Odd while a push or pop is updating its chronos
+{
+    *seq = *seq + 1;
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline void atsSeqEnd(volatile uint32_t *seq)
+{
+    std::atomic_thread_fence(std::memory_order_release);
+    *seq = *seq + 1;
+}
+
+inline int atsChronoPhase(uint32_t *phase, uint32_t every) // Weight for this call, 0 to skip or -1 to restart
+{
+    if (every <= 1)
+        return 1;
+    if (*phase == 0) {
+        *phase = every - 1;
+        return (int)every;
+    }
+    return --(*phase) == 0 ? -1 : 0;
+}
+
+int atsChronoCall(ats_t *p, int call, uint32_t *phase, int64_t callTime, int64_t rateTime, uint64_t now, int samples, bool jitter)
+{
+#ifdef ATS_NO_CHRONOS
+    (void)p;
+    (void)call;
+    (void)phase;
+    (void)callTime;
+    (void)rateTime;
+    (void)now;
+    (void)samples;
+    (void)jitter;
+    return 0;
+#else
+    int weight = atsChronoPhase(phase, p->config.chronoSample);
+    if (weight < 0) {
+        p->chrono[call].restart(callTime);
+        p->chrono[call + 1].restart(rateTime);
+    }
+    if (weight <= 0)
+        return 0;
+    p->chrono[call].event(callTime, 1, weight);
+    p->chrono[call + 1].event(rateTime, samples, weight);
+    p->chrono[call + 2].restart(now); // Restart the chrono used to calculate the time in this routine
+    if (jitter && p->chrono[call + 1].eventCount() > 1)
+        atsJitterUpdate(p, call, p->chrono[call + 1].diffNs(), samples);
+    Perf *perf = call == PUSH ? p->pushPerf : p->popPerf;
+    if (perf != nullptr)
+        perf->begin(); // Last so the counts are of the body of the call
+    return weight;
+#endif
+}
+
+inline void atsChronoExec(ats_t *p, int exec, int samples, int weight) // Record the execution time - weight 0 if skipped
+{
+    if (weight <= 0)
+        return;
+    p->chrono[exec].event(exec == PUSH_EXEC ? atsNow(p->pushSource, p->pushContext) : atsNow(p->popSource, p->popContext), 1, weight);
+    Histogram2D *h = exec == PUSH_EXEC ? p->pushExec : p->popExec;
+    if (h != nullptr && p->chrono[exec].eventCount() > 1)
+        h->add((float)samples, (float)p->chrono[exec].diffNs() * 1E-9F, weight);
+    Perf *perf = exec == PUSH_EXEC ? p->pushPerf : p->popPerf;
+    if (perf != nullptr)
+        perf->end(weight);
+}
+
+#ifdef ATS_STAGE_TIMING
+inline void atsStage(ats_t *p, Event stage, int weight, uint64_t *t) // Time since the last stage boundary
+{
+    if (weight <= 0)
+        return;
+    uint64_t now = atsNow(p->stageSource, nullptr);
+    p->chrono[stage].add((int)(now - *t), weight);
+    *t = now;
+}
+#define ATS_STAGE_BEGIN(t, w) uint64_t t = (w) > 0 ? atsNow(p->stageSource, nullptr) : 0
+#define ATS_STAGE(e, t, w)    atsStage(p, e, w, &t)
+#else
+#define ATS_STAGE_BEGIN(t, w)
+#define ATS_STAGE(e, t, w)
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // MAIN PUSH AND POP
 //
 
+void atsPushData(ats_t *p, int samples, int sampleStride, int channelStride, int32_t *data)
+{
+    for (int s = 0; s < samples; s++) {
+        float *  dst = p->data + p->in * p->config.channels;
+        int32_t *src = data + s * sampleStride;
+        for (int c = 0; c < p->config.channels; c++) {
+            *dst++ = (AtsData)*src;
+            src += channelStride;
+        };
+        p->in = MOD(p->in + 1); // And move along
+    }
+}
+
 void Ats::push(int samples, int sampleStride, int channelStride, int32_t *data, int64_t callTime)
 {
     ats_t *p = (ats_t *)mData;
@@ -406,32 +994,77 @@ void Ats::push(int samples, int sampleStride, int channelStride, int32_t *data,
     assert(samples>0);
     assert((sampleStride==0 && channelStride==0) || samples < p->config.bufferSamples); // Could have a miss longer than the buffer
 
-    if (callTime<1000000000) callTime = Chrono::nowNs() - callTime;
+    atsSeqBegin(&p->pushSeq);
+    uint64_t now = atsNow(p->pushSource, p->pushContext); // One clock read on the way in shared by everything, and one on the way out
+    if (callTime<1000000000) callTime = now - callTime;
 
-    p->chrono[PUSH].event(callTime);
-    p->chrono[PUSH_RATE].event(callTime,samples);
-    p->chrono[PUSH_EXEC].restart(); // Restart the chrono used to calculate the time in this routine
+    int weight = atsChronoCall(p, PUSH, &p->pushPhase, callTime, callTime, now, samples, true);
+    ATS_STAGE_BEGIN(stage, weight);
 
     // Convert sample point and time to 0..2^32.
+    p->pushExactN = 0; // Back to filtering the call times
     if (p->config.filterPush) {
         uint32_t offset = (uint32_t)((((uint64_t)p->in + samples) << (32 - ATS_BUFFER_SIZE_LOG2)) - (((callTime) * p->maxIntDivT) >> (10 + ATS_BUFFER_SIZE_LOG2)));
         p->pushOffset[p->pushOffsetN++ % p->config.filterPush] = offset;
     }
+    ATS_STAGE(PUSH_OFFSET, stage, weight);
 
     if (!(p->config.mode & ATS_TRACKING_OFF))
-        atsTrack(); // Update the tracking before pushing data so we record the lowest buffer depth
+        atsTrack(now); // Update the tracking before pushing data so we record the lowest buffer depth
+    ATS_STAGE(PUSH_TRACK, stage, weight);
 
-    for (int s = 0; s < samples; s++) {
-        float *  dst = p->data + p->in * p->config.channels;
-        int32_t *src = data + s * sampleStride;
-        for (int c = 0; c < p->config.channels; c++) {
-            *dst++ = (AtsData)*src;
-            src += channelStride;
-        };
-        p->in = MOD(p->in + 1); // And move along
+    atsPushData(p, samples, sampleStride, channelStride, data);
+    ATS_STAGE(PUSH_DATA, stage, weight);
+
+    atsChronoExec(p, PUSH_EXEC, samples, weight);
+    atsSeqEnd(&p->pushSeq);
+}
+
+void Ats::pushTimed(int samples, int sampleStride, int channelStride, int32_t *data, int64_t sampleTime, int64_t sampleIndex)
+{
+    ats_t *p = (ats_t *)mData;
+    assert(p->configs > 0);
+    assert(data!=nullptr);
+    assert(samples>0);
+    assert(samples < p->config.bufferSamples);
+
+    atsSeqBegin(&p->pushSeq);
+    uint64_t now = atsNow(p->pushSource, p->pushContext);
+    int weight = atsChronoCall(p, PUSH, &p->pushPhase, now, sampleTime, now, samples, false);
+    ATS_STAGE_BEGIN(stage, weight);
+
+    if (sampleIndex >= 0 && p->pushIndex >= 0) {  // Line up with the media position
+        int64_t gap = sampleIndex - p->pushIndex;
+        if (gap > 0 && gap < p->config.bufferSamples / 2)
+            p->in = MOD(p->in + (int)gap);            // Missed samples - the ring is already zero behind pop
+        else if (gap < 0 && -gap < p->config.bufferSamples / 2 && -gap >= samples) {
+            atsChronoExec(p, PUSH_EXEC, samples, weight);      // Nothing new in this block
+            atsSeqEnd(&p->pushSeq);
+            return;
+        } else if (gap < 0 && -gap < p->config.bufferSamples / 2) {
+            data       -= gap * sampleStride;         // Drop the overlap we already have
+            sampleTime -= (int64_t)((float)gap * 1E9F / p->config.inRate);
+            samples    += (int)gap;
+            sampleIndex-= gap;
+        }
     }
+    if (sampleIndex >= 0)
+        p->pushIndex = sampleIndex + samples;
 
-    p->chrono[PUSH_EXEC].event(); // Record the execution time
+    // The exact invariant of the first sample in the block
+    p->pushExact = (uint32_t)(((uint64_t)p->in << (32 - ATS_BUFFER_SIZE_LOG2)) - (((sampleTime) * p->maxIntDivT) >> (10 + ATS_BUFFER_SIZE_LOG2)));
+    p->pushExactN++;
+    ATS_STAGE(PUSH_OFFSET, stage, weight);
+
+    if (!(p->config.mode & ATS_TRACKING_OFF))
+        atsTrack(now);
+    ATS_STAGE(PUSH_TRACK, stage, weight);
+
+    atsPushData(p, samples, sampleStride, channelStride, data);
+    ATS_STAGE(PUSH_DATA, stage, weight);
+
+    atsChronoExec(p, PUSH_EXEC, samples, weight);
+    atsSeqEnd(&p->pushSeq);
 }
 
 void Ats::skip(int samples)
@@ -441,19 +1074,24 @@ void Ats::skip(int samples)
 }
 
 void atsInterp(ats_t *p, int samples, int sample_stride, int channel_stride, AtsData *data);
+void atsInterpSkip(ats_t *p, int samples);
+void atsPopConvert(ats_t *p, int samples, int sampleStride, int channelStride, int32_t *data);
 
-void Ats::pop(int samples, int sampleStride, int channelStride, AtsData *dst, int64_t callTime)
+// The int32_t pops convert in place before the pop sequence closes, so the conversion is part of POP_EXEC, and
+// the counters and stage times of a call are complete in any snapshot
+void atsPop(ats_t *p, int samples, int sampleStride, int channelStride, AtsData *dst, int64_t callTime, int32_t *convert)
 {
-    ats_t *p = (ats_t *)mData;
     assert(p->configs > 0);
 
-    if (callTime<10000000000) callTime = Chrono::nowNs() - callTime;
+    atsSeqBegin(&p->popSeq);
+    uint64_t now = atsNow(p->popSource, p->popContext); // One clock read on the way in shared by everything, and one on the way out
+    if (callTime<10000000000) callTime = now - callTime;
         
-    p->chrono[POP].event(callTime);
-    p->chrono[POP_RATE].event(callTime,samples);
-    p->chrono[POP_EXEC].restart();
+    int weight = atsChronoCall(p, POP, &p->popPhase, callTime, callTime, now, samples, true);
+    ATS_STAGE_BEGIN(stage, weight);
 
     // Invariant based on first sample - as this is closest to what is about to be played out
+    p->popExactN = 0;
     if (p->config.filterPop) {
         uint32_t offset = (uint32_t)( ( (uint64_t)p->outN<<(32-ATS_BUFFER_SIZE_LOG2)) +
                                       (           p->outF>>(ATS_BUFFER_SIZE_LOG2-4))  -			// Include fractional part
@@ -465,23 +1103,72 @@ void Ats::pop(int samples, int sampleStride, int channelStride, AtsData *dst, in
     int have = SUB(p->in, p->outN);                          // Work out how much we have
     if (need > have)                                         // We need to create some new samples
     {
-        p->chrono[UNDER_RUN].event();
-        p->chrono[UNDER_RUN_SIZE].count(need - have);
+        ATS_CHRONO(p->chrono[UNDER_RUN].event(now));
+        ATS_CHRONO(p->chrono[UNDER_RUN_SIZE].count(need - have, 1, now));
     }
+    ATS_STAGE(POP_OFFSET, stage, weight);
 
     atsInterp(p, samples, sampleStride, channelStride, dst);
+    ATS_STAGE(POP_INTERP, stage, weight);
 
-    p->chrono[POP_EXEC].event();
+    if (convert != nullptr) {
+        atsPopConvert(p, samples, sampleStride, channelStride, convert);
+        ATS_STAGE(POP_CONVERT, stage, weight);
+    }
+
+    atsChronoExec(p, POP_EXEC, samples, weight);
+    atsSeqEnd(&p->popSeq);
 }
 
-void Ats::pop(int samples, int sampleStride, int channelStride, int32_t *data, int64_t callTime)
+void atsPopTimed(ats_t *p, int samples, int sampleStride, int channelStride, AtsData *dst, int64_t sampleTime, int64_t sampleIndex, int32_t *convert)
+{
+    assert(p->configs > 0);
+
+    atsSeqBegin(&p->popSeq);
+    uint64_t now = atsNow(p->popSource, p->popContext);
+    int weight = atsChronoCall(p, POP, &p->popPhase, now, sampleTime, now, samples, false);
+    ATS_STAGE_BEGIN(stage, weight);
+
+    if (sampleIndex >= 0 && p->popIndex >= 0) { // Output the device dropped is consumed silently
+        int64_t gap = sampleIndex - p->popIndex;
+        if (gap > 0 && gap < p->config.bufferSamples / 2)
+            atsInterpSkip(p, (int)gap);
+    }
+    if (sampleIndex >= 0)
+        p->popIndex = sampleIndex + samples;
+
+    p->popExact = (uint32_t)(((uint64_t)p->outN << (32 - ATS_BUFFER_SIZE_LOG2)) + (p->outF >> (ATS_BUFFER_SIZE_LOG2 - 4)) -
+                             (((sampleTime) * p->maxIntDivT) >> (10 + ATS_BUFFER_SIZE_LOG2)));
+    p->popExactN++;
+
+    int need = ats_4f28u_advance(p->outF, p->step, samples);
+    int have = SUB(p->in, p->outN);
+    if (need > have)
+    {
+        ATS_CHRONO(p->chrono[UNDER_RUN].event(now));
+        ATS_CHRONO(p->chrono[UNDER_RUN_SIZE].count(need - have, 1, now));
+    }
+    ATS_STAGE(POP_OFFSET, stage, weight);
+
+    atsInterp(p, samples, sampleStride, channelStride, dst);
+    ATS_STAGE(POP_INTERP, stage, weight);
+
+    if (convert != nullptr) {
+        atsPopConvert(p, samples, sampleStride, channelStride, convert);
+        ATS_STAGE(POP_CONVERT, stage, weight);
+    }
+
+    atsChronoExec(p, POP_EXEC, samples, weight);
+    atsSeqEnd(&p->popSeq);
+}
+
+void atsPopConvert(ats_t *p, int samples, int sampleStride, int channelStride, int32_t *data)
 {
     // NOTE THAT THIS IS AN INPLACE CONVERSION FLOAT -> INT   INTS are briefly 'invalid'
     // SHOULD CHECK HERE THAT AtsData == float - otherwise we are already fixed point
-    pop(samples, sampleStride, channelStride, (AtsData *)data, callTime);
     for (int s = 0; s < samples; s++) {
         float *dst = (float *)data + s * sampleStride;
-        for (int c = 0; c < getConfig()->channels; c++) {
+        for (int c = 0; c < p->config.channels; c++) {
             // 0x7FFE0000 is a safe saturation if the audio is truncated to 16 bit (with dither)
             if (*dst > (float)0x7FFE0000)
                 *dst = (float)0x7FFE0000;
@@ -493,6 +1180,26 @@ void Ats::pop(int samples, int sampleStride, int channelStride, int32_t *data, i
     }
 }
 
+void Ats::pop(int samples, int sampleStride, int channelStride, AtsData *dst, int64_t callTime)
+{
+    atsPop((ats_t *)mData, samples, sampleStride, channelStride, dst, callTime, nullptr);
+}
+
+void Ats::popTimed(int samples, int sampleStride, int channelStride, AtsData *dst, int64_t sampleTime, int64_t sampleIndex)
+{
+    atsPopTimed((ats_t *)mData, samples, sampleStride, channelStride, dst, sampleTime, sampleIndex, nullptr);
+}
+
+void Ats::pop(int samples, int sampleStride, int channelStride, int32_t *data, int64_t callTime)
+{
+    atsPop((ats_t *)mData, samples, sampleStride, channelStride, (AtsData *)data, callTime, data);
+}
+
+void Ats::popTimed(int samples, int sampleStride, int channelStride, int32_t *data, int64_t sampleTime, int64_t sampleIndex)
+{
+    atsPopTimed((ats_t *)mData, samples, sampleStride, channelStride, (AtsData *)data, sampleTime, sampleIndex, data);
+}
+
 void atsInterpHold(ats_t *p, int samples, int sampleStride, int channelStride, AtsData *data);
 void atsInterpLinear(ats_t *p, int samples, int sampleStride, int channelStride, AtsData *data);
 void atsInterpSpline3(ats_t *p, int samples, int sampleStride, int channelStride, AtsData *data);
@@ -0,0 +1,187 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// ats_fixed.cpp
+//
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// FIXED POINT TRACKING LOOP
+//
+// An integer only version of the PI control loop, warp and slew limiter for targets without an FPU.  It is
+// selected with ATS_TRACKING_FIXED and follows atsTrackFloat step for step.  Only the gain conversion in
+// atsTrackFixedConfig uses float, and that runs once per configuration.
+//
+// Representations
+//   latency and error   Q8 samples
+//   rate offsets        Q16 ppm                  (+-32767 ppm before saturation)
+//   tracking period     1024ns units             (a shift from ns with the 1.024 folded into the gains)
+//   fixKp               Q16 ppm per sample
+//   fixKi               Q40 ppm per sample per 1024ns
+//   fixRate             Q32 ppm per 1024ns
+//   call jitter         Q8 samples               (from ns with fixInNs and fixOutNs, Q40 samples per ns)
+//   filter adaption     Q16                      (0 quiet to 1 at filterJitter, through fixJitterInv)
+//
+// tools/ats_replay drives both loops on the same simulated call times (0, 100 and -300 ppm, 0.5..20 samples of
+// jitter, with and without warp and slew) and the step stays within 10 LSB of the 4.28 step (under 0.04 ppm)
+// at every update, with a mean under 4 LSB.  Most of that is the float loop's own rounding of trackInt.  The
+// adaptive offset filters pick a neighbouring offset to the float ones on under 2% of the updates.
+// The call jitter is also kept in Q8 samples and the offset filters adapt in Q16, so nothing per call is float.
+// All shifts round to nearest, as a truncating shift biases the integrator and drifts by tenths of a ppm.
+//
+
+#include "ats.h"
+#include "ats_t.h"
+#include <stdint.h>
+
+namespace Audinate { namespace ats {
+
+#define ATS_FIX_ONE_PPM  (1 << 16)  // Q16 ppm
+#define ATS_FIX_T_MAX    (1 << 20)  // Clamp on the tracking period - around 1s
+#define ATS_FIX_ERR_MAX  (1 << 23)  // Clamp on the error - 32768 samples in Q8
+
+inline int64_t atsFixShr(int64_t x, int n) { return (x + ((int64_t)1 << (n - 1))) >> n; } // Rounded - no drift in the integrator
+inline int32_t atsFixSat(int64_t x) { return x > INT32_MAX ? INT32_MAX : (x < -INT32_MAX ? -INT32_MAX : (int32_t)x); }
+
+void atsTrackFixedConfig(ats_t *p)
+{
+    p->fixKp         = atsFixSat((int64_t)(p->config.trackKp * 65536.0F));
+    p->fixKi         = atsFixSat((int64_t)(p->config.trackKi * 1.024E-6 * 1099511627776.0));
+    p->fixRate       = atsFixSat((int64_t)(p->config.trackRate * 1.024E-6 * 4294967296.0));
+    p->fixWarp       = atsFixSat((int64_t)(p->config.trackWarp * 256.0F));
+    p->fixWarpInv    = p->fixWarp > 0 ? (int32_t)(((int64_t)1 << 31) / p->fixWarp) : 0; // 2^32 / (2*warp)
+    p->fixInNs       = atsFixSat((int64_t)(p->config.inRate * 1099.511627776)); // Q40 samples per ns - 2^40 / 1E9
+    p->fixOutNs      = atsFixSat((int64_t)(p->config.outRate * 1099.511627776));
+    p->fixJitter     = atsFixSat((int64_t)(p->config.filterJitter * 256.0F));
+    p->fixJitterInv  = p->fixJitter > 0 ? atsFixSat(((int64_t)1 << 32) / p->fixJitter) : 0; // Q16 adapt from Q8 jitter
+    p->fixPushJitter = p->fixJitter; // Start wide, as the float jitter does
+    p->fixPopJitter  = p->fixJitter;
+}
+
+int32_t atsLatencyFixed(ats_t *p) // Q8 samples
+{
+    p->trackPush    = atsPushOffset(p);
+    p->trackPop     = atsPopOffset(p);
+    int32_t offset  = (int32_t)(p->trackPush - p->trackPop); // Note that this is a wrapping int
+    int32_t latency = (int32_t)atsFixShr(offset, 32 - ATS_BUFFER_SIZE_LOG2 - 8);
+    if (latency < -1 * (p->config.bufferSamples / 4) * 256)
+        latency += p->config.bufferSamples * 256;
+    if (latency > 3 * (p->config.bufferSamples / 4) * 256)
+        latency -= p->config.bufferSamples * 256;
+    return latency;
+}
+
+void atsTrackFixed(ats_t *p, int64_t diffNs, uint64_t now)
+{
+    int64_t t = atsFixShr(diffNs, 10);
+    if (t > ATS_FIX_T_MAX)
+        t = ATS_FIX_T_MAX;
+    p->fixT = (int32_t)atsFixShr(t + p->fixT, 1); // Mild smoothing - used to calculate integration
+
+    int32_t latency = atsLatencyFixed(p);
+    int32_t error   = p->config.trackTarget * 256 - latency;
+    if (error > ATS_FIX_ERR_MAX)
+        error = ATS_FIX_ERR_MAX;
+    if (error < -ATS_FIX_ERR_MAX)
+        error = -ATS_FIX_ERR_MAX;
+
+    if (p->config.trackRange > 0) {
+        int32_t range = p->config.trackRange * 256;
+        if (error > range)
+            p->in = MOD(p->in + ((error - range + 128) >> 8));
+        if (error < -range)
+            p->outN = MOD(p->outN + ((-error - range + 128) >> 8));
+    }
+
+    if (p->fixWarp > 0) // Warp the proportional to reduce noise
+    {
+        if (error < -p->fixWarp)
+            error += p->fixWarp >> 1;
+        else if (error > p->fixWarp)
+            error -= p->fixWarp >> 1;
+        else if (error > 0)
+            error = (int32_t)atsFixShr((int64_t)error * error * p->fixWarpInv, 32);
+        else
+            error = -(int32_t)atsFixShr((int64_t)error * error * p->fixWarpInv, 32);
+    }
+    p->fixProp = atsFixSat(atsFixShr((int64_t)p->fixKp * error, 8));                                    // Proportional term
+    p->fixInt  = atsFixSat(p->fixInt + atsFixShr(atsFixShr((int64_t)p->fixKi * error, 8) * p->fixT, 24)); // Time adjusted integral
+    p->fixOff  = atsFixSat((int64_t)p->fixProp + p->fixInt);
+    if (p->fixRate > 0) // Apply slew rate limiting if enabled
+    {
+        int64_t diff = (int64_t)p->fixOff - p->fixSlew;
+        int64_t slew = atsFixShr((int64_t)p->fixRate * p->fixT, 16);
+        if (diff > slew)
+            p->fixSlew = atsFixSat(p->fixSlew + slew);
+        else if (diff < -slew)
+            p->fixSlew = atsFixSat(p->fixSlew - slew);
+        else
+            p->fixSlew = p->fixOff;
+    } else
+        p->fixSlew = p->fixOff;
+
+    // step0 * slew / 1E6 with the 1E-6 as 4398046 / 2^42 - first scale slew to a 0.32 fraction
+    int64_t frac = atsFixShr((int64_t)p->fixSlew * 4398046, 26);
+    p->step      = p->trackStep0 - (int32_t)atsFixShr(frac * p->trackStep0, 32);
+
+    (void)now;
+    ATS_CHRONO(p->chrono[LATENCY].count((latency + 128) >> 8, 1, now)); // As the float loop
+    ATS_CHRONO(p->chrono[DEPTH].count(SUB(p->in, p->outN), 1, now));
+    ATS_CHRONO(p->chrono[OFFSET].count((p->fixSlew + ATS_FIX_ONE_PPM / 2) >> 16, 1, now));
+}
+
+}} // namespace Audinate::ats
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
\ No newline at end of file
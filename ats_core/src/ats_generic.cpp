@@ -116,6 +116,18 @@ inline void atsInterpAdvance(ats_t *p)   // Helper function to advance one incre
     p->outN       = MOD(p->outN + inc);  // Modulo bufferSize the increment
 }
 
+void atsInterpSkip(ats_t *p, int samples) // Consume output without producing it - clears the input as the
+{                                          // interpolator would, from the oldest sample it still uses
+    static const int delay[] = {0, 1, 3, 5};
+    int              d       = delay[p->config.mode & ATS_INTERP_MASK & 3];
+    for (int s = 0; s < samples; s++) {
+        AtsData *p0 = p->data + MOD(p->outN - d) * p->config.channels;
+        for (int c = 0; c < p->config.channels; c++)
+            *p0++ = 0;
+        atsInterpAdvance(p);
+    }
+}
+
 void atsInterpHold(ats_t *p, int samples, int sampleStride, int channelStride, AtsData *data)
 {
     for (int s = 0; s < samples; s++) {
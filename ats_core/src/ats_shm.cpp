@@ -0,0 +1,312 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// ats_shm.cpp
+//
+
+#if defined(__linux__) || defined(__APPLE__)
+#define ATS_SHM
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ats_shm.h"
+#include <assert.h>
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+namespace Audinate { namespace ats {
+
+struct shm_t
+{
+    void * map;      // The mapping - nullptr if not open
+    size_t size;     // Bytes mapped
+    int    slots;    // Slots following the header
+    int    writable; // Created here rather than opened to monitor
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SLOT STATE
+//
+// The state only ever counts up.  A claim moves a free slot (0 in the low bits) to 1 with a compare and swap,
+// so instances in different threads can share at once, publish moves it on to live (2) once the chronos are in
+// place, and release moves it to the next free value.  A reader takes a live state, copies, and checks it is
+// unchanged, so a slot released and claimed again under it is never mistaken for the one it started on.
+//
+
+inline AtsShmSlot *shmSlot(shm_t *p, int n)
+{
+    return (AtsShmSlot *)((char *)p->map + sizeof(AtsShmHeader)) + n;
+}
+
+#ifdef ATS_SHM
+static bool shmStale(const char *name) // Left by a process that has gone, or by this one
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return errno == ENOENT;
+    struct stat st;
+    void *      map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(AtsShmHeader))
+        map = mmap(nullptr, sizeof(AtsShmHeader), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+    const AtsShmHeader *h   = (const AtsShmHeader *)map;
+    pid_t               pid = (pid_t)h->pid;
+    bool stale = h->magic == ATS_SHM_MAGIC && h->version == ATS_SHM_VERSION && (pid == getpid() || (kill(pid, 0) != 0 && errno == ESRCH));
+    munmap(map, sizeof(AtsShmHeader));
+    return stale;
+}
+#endif
+
+AtsShm::AtsShm()
+{
+    assert(sizeof(mData) >= sizeof(shm_t)); // Ensure hidden data allocation is sufficient
+    memset(mData, 0, sizeof(shm_t));
+}
+
+AtsShm::~AtsShm() { close(); }
+
+bool AtsShm::create(const char *name, int slots)
+{
+    shm_t *p = (shm_t *)mData;
+    close();
+#ifdef ATS_SHM
+    if (slots <= 0)
+        return false;
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST && shmStale(name)) {
+        shm_unlink(name); // Only a region whose creator has gone - a live one is left alone
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0)
+        return false;
+    size_t size = sizeof(AtsShmHeader) + (size_t)slots * sizeof(AtsShmSlot);
+    if (ftruncate(fd, (off_t)size) != 0) {
+        ::close(fd);
+        shm_unlink(name);
+        return false;
+    }
+    void *map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(name);
+        return false;
+    }
+
+    AtsShmHeader *h = (AtsShmHeader *)map; // New pages are zero, so only the header needs filling
+    h->version      = ATS_SHM_VERSION;
+    h->headerSize   = sizeof(AtsShmHeader);
+    h->slotSize     = sizeof(AtsShmSlot);
+    h->slots        = (uint32_t)slots;
+    h->events       = EVENTS;
+    h->chronoSize   = sizeof(Chrono);
+    h->poolBins     = ATS_CHRONO_POOL;
+    h->pid          = (uint32_t)getpid();
+    std::atomic_thread_fence(std::memory_order_release);
+    h->magic = ATS_SHM_MAGIC; // Last so a monitor never takes a part written header
+
+    p->map      = map;
+    p->size     = size;
+    p->slots    = slots;
+    p->writable = 1;
+    return true;
+#else
+    (void)name;
+    (void)slots;
+    return false;
+#endif
+}
+
+bool AtsShm::open(const char *name)
+{
+    shm_t *p = (shm_t *)mData;
+    close();
+#ifdef ATS_SHM
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    void *      map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(AtsShmHeader))
+        map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    const AtsShmHeader *h = (const AtsShmHeader *)map;
+    bool ok = h->magic == ATS_SHM_MAGIC && h->version == ATS_SHM_VERSION && h->headerSize == sizeof(AtsShmHeader) &&
+              h->slotSize == sizeof(AtsShmSlot) && h->events == EVENTS && h->chronoSize == sizeof(Chrono) &&
+              h->poolBins == ATS_CHRONO_POOL &&
+              (size_t)st.st_size >= sizeof(AtsShmHeader) + (size_t)h->slots * sizeof(AtsShmSlot);
+    if (!ok) {
+        munmap(map, (size_t)st.st_size);
+        return false;
+    }
+    p->map      = map;
+    p->size     = (size_t)st.st_size;
+    p->slots    = (int)h->slots;
+    p->writable = 0;
+    return true;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+void AtsShm::close()
+{
+    shm_t *p = (shm_t *)mData;
+#ifdef ATS_SHM
+    if (p->map != nullptr)
+        munmap(p->map, p->size);
+#endif
+    memset(p, 0, sizeof(shm_t));
+}
+
+bool AtsShm::unlink(const char *name)
+{
+#ifdef ATS_SHM
+    return shm_unlink(name) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+const AtsShmHeader *AtsShm::header() { return (const AtsShmHeader *)((shm_t *)mData)->map; }
+
+int AtsShm::slots() { return ((shm_t *)mData)->slots; }
+
+bool AtsShm::snapshot(int slot, Chrono *chronos, uint32_t *storage, int storageBins, char *label, int tries)
+{
+    shm_t *p = (shm_t *)mData;
+    if (p->map == nullptr || slot < 0 || slot >= p->slots)
+        return false;
+    AtsShmSlot *s = shmSlot(p, slot);
+
+    for (; tries > 0; tries--) {
+        uint32_t state = *(volatile uint32_t *)&s->state;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((state & 3) != 2)
+            return false;
+        int used = 0, n;
+        for (n = 0; n < EVENTS; n++) {
+            int bins = s->chrono[n].snapshot(&chronos[n], storage + used, storageBins - used, tries);
+            if (bins < 0)
+                break;
+            used += bins;
+        }
+        if (label != nullptr)
+            memcpy(label, s->label, sizeof(s->label));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (*(volatile uint32_t *)&s->state != state)
+            continue;
+        if (n < EVENTS)
+            return false;
+        for (n = 0; n < EVENTS; n++)
+            chronos[n].setSource(); // Nothing of the producer's address space - they read the clock of this process
+        if (label != nullptr)
+            label[sizeof(s->label) - 1] = 0;
+        return true;
+    }
+    return false;
+}
+
+AtsShmSlot *AtsShm::claim(const char *label)
+{
+    shm_t *p = (shm_t *)mData;
+    if (p->map == nullptr || !p->writable)
+        return nullptr;
+#ifdef ATS_SHM
+    for (int n = 0; n < p->slots; n++) {
+        AtsShmSlot *s     = shmSlot(p, n);
+        uint32_t    state = *(volatile uint32_t *)&s->state;
+        if ((state & 3) != 0 || !__sync_bool_compare_and_swap(&s->state, state, state + 1))
+            continue;
+        memset(s->label, 0, sizeof(s->label));
+        if (label != nullptr)
+            strncpy(s->label, label, sizeof(s->label) - 1);
+        return s;
+    }
+#else
+    (void)label;
+#endif
+    return nullptr;
+}
+
+void AtsShm::publish(AtsShmSlot *slot)
+{
+    std::atomic_thread_fence(std::memory_order_release);
+    *(volatile uint32_t *)&slot->state = slot->state + 1;
+}
+
+void AtsShm::release(AtsShmSlot *slot)
+{
+    std::atomic_thread_fence(std::memory_order_release);
+    *(volatile uint32_t *)&slot->state = (slot->state | 3) + 1;
+}
+
+}} // namespace Audinate::ats
+
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
\ No newline at end of file
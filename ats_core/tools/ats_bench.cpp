@@ -0,0 +1,493 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// ats_bench.cpp
+//
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MICROBENCHMARKS
+//
+// Times the calls that run per block or per event, each as the best of a few runs of at least the given time,
+// and prints one CSV line per case to stdout for scripts to compare across builds and machines.
+//
+//     ats_bench [-t ms] [-j threads] [-c channels,...] [-b samples,...] [group ...]
+//
+// The groups, all by default, are
+//     clock    the process clock and the built in sources
+//     chrono   Chrono::event and add in each binning mode, after checking the bin lookup against the divide
+//     hist     Histogram::add scalar, atomic and batched, Histogram2D::add and snapshot, quiet and with a writer
+//     shards   HistShards adds from 1 up to -j threads at once, and the atomic path
+//     filter   the push and pop offset filters, through getLatency, fixed and adaptive
+//     mode     push and pop for each interpolation with each tracking flag, 2 channels of 64 samples
+//     pushpop  push and pop for each interpolation over the channels and block sizes, float and int32 output
+//
+// The columns are
+//     group,case,output,channels,threads,samples,ns_per_call,ns_per_sample,samples_per_s,fail_rate
+// where samples is the samples (frames of all channels) or values handled per call, so ns_per_sample and
+// samples_per_s are per frame for push and pop.  For shards ns_per_call is the wall time over the adds of one
+// thread and samples_per_s the adds of all threads per second.  Push and pop are given synthetic call times
+// at 48kHz, so the offsets and tracking see a steady stream, and the depth is put back before each chunk of
+// calls.  The push and pop of a case are timed a chunk at a time, with the cost of the clock reads taken off.
+// fail_rate is the fraction of calls that did nothing useful - the live snapshots that found no clean copy -
+// and 0 for the rest.
+// On a machine with fewer cores than threads the shards and live snapshot lines measure contention for the
+// core rather than for the cache lines.
+
+//
+// The chrono group first sweeps the shift and multiply high bin lookup over bin widths and offsets around every
+// kind of bin edge, comparing each with the plain divide.  Any difference is printed and the bench exits 1.
+//
+
+#include "ats.h"
+#include "hist2d.h"
+#include "shard.h"
+#include <atomic>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace Audinate::ats;
+
+#define BENCH_REPS   3    // Best of
+#define BENCH_VALUES 4096 // Random values cycled through by the scalar adds
+#define BENCH_BLOCK  256  // Values per batched add
+#define BENCH_RATE   48000.0
+
+static uint64_t benchMinNs = 20000000; // Each run at least this long
+static double   benchClockNs;          // Cost of a clock read, taken off the chunks of push and pop
+static float    benchValue[BENCH_VALUES];
+static int32_t  benchInt32[BENCH_VALUES];
+static int16_t  benchInt16[BENCH_VALUES];
+
+template <typename F> static double benchNs(F body) // Best ns per call of body(calls)
+{
+    int      calls = 1;
+    uint64_t t     = 0;
+    while (t < benchMinNs / 8 && calls < (1 << 30)) { // Find a count that runs long enough
+        calls *= 2;
+        uint64_t t0 = Chrono::nowNs();
+        body(calls);
+        t = Chrono::nowNs() - t0;
+    }
+    if (t < benchMinNs)
+        calls = (int)((double)calls * benchMinNs / (t > 0 ? t : 1));
+    double best = 1e30;
+    for (int r = 0; r < BENCH_REPS; r++) {
+        uint64_t t0 = Chrono::nowNs();
+        body(calls);
+        double ns = (double)(Chrono::nowNs() - t0) / calls;
+        best      = ns < best ? ns : best;
+    }
+    return best;
+}
+
+static void benchLine(const char *group, const char *name, const char *output, int channels, int threads, int samples, double nsPerCall, double samplesPerS = 0, double failRate = 0)
+{
+    if (samplesPerS == 0)
+        samplesPerS = nsPerCall > 0 ? samples * 1E9 / nsPerCall : 0;
+    printf("%s,%s,%s,%d,%d,%d,%.2f,%.4f,%.0f,%.4f\n", group, name, output, channels, threads, samples, nsPerCall, nsPerCall / samples, samplesPerS, failRate);
+    fflush(stdout);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// CLOCK, CHRONO AND HISTOGRAM
+//
+
+static void benchClock()
+{
+    volatile uint64_t sink = 0;
+    benchLine("clock", "nowNs", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) sink += Chrono::nowNs(); }));
+    const struct { const char *name; chrono_clock clock; } clocks[] = { { "mono", MONO }, { "realtime", REALTIME }, { "tsc", TSC } };
+    for (auto &c : clocks) {
+        ChronoSource source = Chrono::source(c.clock);
+        benchLine("clock", c.name, "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) sink += source(nullptr); }));
+    }
+}
+
+static bool benchBinCheck() // The bin lookup against the divide, for the widths and offsets most likely to differ
+{
+    std::vector<uint32_t> widths;
+    for (uint32_t w = 1; w <= 1024; w++)
+        widths.push_back(w);
+    for (int b = 11; b < 32; b++)
+        widths.insert(widths.end(), { (1U << b) - 1, 1U << b, (1U << b) + 1 });
+    widths.insert(widths.end(), { 1000, 3000, 20833, 1000000, 0xFFFFFFFF });
+    uint64_t r = 1;
+    for (int n = 0; n < 2000; n++) {
+        r = r * 6364136223846793005ULL + 1442695040888963407ULL;
+        widths.push_back((uint32_t)(r >> 32) >> (n % 24));
+    }
+
+    int64_t checks = 0, wrong = 0;
+    for (uint32_t w : widths) {
+        if (w == 0)
+            continue;
+        std::vector<uint64_t> k = { 0, 1, 2, 3, 99, 100, 101, 2047, 2048 }; // Bins either side of the clamps
+        uint64_t top = ((uint64_t)1 << 32) / w;                                // Either side of the multiply high range
+        k.insert(k.end(), { top - 1, top, top + 1 });
+        for (int n = 0; n < 16; n++) {
+            r = r * 6364136223846793005ULL + 1442695040888963407ULL;
+            k.push_back((r >> 16) % (top + 2));
+        }
+        for (uint64_t b : k)
+            for (int64_t e : { (int64_t)-1, (int64_t)0, (int64_t)1, (int64_t)w - 1 }) {
+                int64_t d = (int64_t)(b * w) + e;
+                for (int bins : { 101, 2048, 1 << 30 }) {
+                    int64_t want = d <= 0 ? 0 : d / w >= bins ? bins - 1 : d / w;
+                    int     got  = Chrono::bin(d, w, bins);
+                    checks++;
+                    if (got != want && wrong++ < 10)
+                        fprintf(stderr, "ats_bench: width %u offset %lld bins %d gave bin %d not %lld\n", w, (long long)d, bins, got, (long long)want);
+                }
+            }
+    }
+    if (wrong)
+        fprintf(stderr, "ats_bench: %lld of %lld bin lookups differ from the divide\n", (long long)wrong, (long long)checks);
+    return wrong == 0;
+}
+
+static void benchChrono()
+{
+    Chrono   c;
+    uint64_t t = 1000000000;
+    c.config(0, 0.0001F, 101, DITHER);
+    benchLine("chrono", "event_clock", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) c.event(); }));
+    c.setSource(Chrono::source(TSC));
+    benchLine("chrono", "event_tsc", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) c.event(); }));
+    c.setSource();
+    benchLine("chrono", "event", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) c.event(t += 1000 + (i & 255)); }));
+    benchLine("chrono", "event_count16", "-", 0, 1, 16, benchNs([&](int calls) { for (int i = 0; i < calls; i++) c.event(t += 16000 + (i & 255), 16); }));
+    c.config(1E-7F, 0.01F, 101, DITHER | LOGX);
+    benchLine("chrono", "event_logx", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) c.event(t += 1000 + (i & 4095)); }));
+    c.configLogLin(1E-7F, 0.01F, 2);
+    benchLine("chrono", "event_loglin", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) c.event(t += 1000 + (i & 4095)); }));
+    c.config(0, 100, 101, COUNTER);
+    benchLine("chrono", "add", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) c.add(i & 127); }));
+}
+
+static void benchHist()
+{
+    Histogram h;
+    const struct { const char *name; HistFlag flags; } scalar[] = { { "add", NONE }, { "add_dither", DITHER }, { "add_logx", DITHER | LOGX } };
+    for (auto &s : scalar) {
+        h.config(0.01F, 1, 101, s.flags);
+        benchLine("hist", s.name, "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) h.add(benchValue[i & (BENCH_VALUES - 1)]); }));
+    }
+    h.config(0.01F, 1, 101, DITHER);
+    benchLine("hist", "add_atomic", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) h.addAtomic(benchValue[i & (BENCH_VALUES - 1)]); }));
+    benchLine("hist", "add_batch_float", "-", 0, 1, BENCH_BLOCK, benchNs([&](int calls) { for (int i = 0; i < calls; i++) h.add(benchValue + (i * BENCH_BLOCK & (BENCH_VALUES - 1)), BENCH_BLOCK); }));
+    h.config(-1E9F, 1E9F, 101, DITHER);
+    benchLine("hist", "add_batch_int32", "-", 0, 1, BENCH_BLOCK, benchNs([&](int calls) { for (int i = 0; i < calls; i++) h.add(benchInt32 + (i * BENCH_BLOCK & (BENCH_VALUES - 1)), BENCH_BLOCK); }));
+    h.config(-30000, 30000, 101, DITHER);
+    benchLine("hist", "add_batch_int16", "-", 0, 1, BENCH_BLOCK, benchNs([&](int calls) { for (int i = 0; i < calls; i++) h.add(benchInt16 + (i * BENCH_BLOCK & (BENCH_VALUES - 1)), BENCH_BLOCK); }));
+    h.config(0.01F, 1, 101, DITHER | LOGX);
+    benchLine("hist", "add_batch_logx", "-", 0, 1, BENCH_BLOCK, benchNs([&](int calls) { for (int i = 0; i < calls; i++) h.add(benchValue + (i * BENCH_BLOCK & (BENCH_VALUES - 1)), BENCH_BLOCK); }));
+
+    Histogram2D h2;
+    h2.config(1, 1024, 11, COUNTER | LOGX, 0.01F, 1, 80, DITHER | LOGX);
+    benchLine("hist", "add_2d", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) h2.add((float)(1 + (i & 1023)), benchValue[i & (BENCH_VALUES - 1)]); }));
+
+    Histogram copy; // Snapshot quiet, then against a writer adding on another thread
+    h.config(0.01F, 1, 101, DITHER);
+    benchLine("hist", "snapshot", "-", 0, 1, 1, benchNs([&](int calls) { for (int i = 0; i < calls; i++) h.snapshot(&copy); }));
+    std::atomic<bool> stop(false);
+    std::thread       writer([&]() { for (int i = 0; !stop.load(std::memory_order_relaxed); i++) h.add(benchValue[i & (BENCH_VALUES - 1)]); });
+    int64_t           failed = 0, tried = 0;
+    double            ns     = benchNs([&](int calls) { for (int i = 0; i < calls; i++) failed += !h.snapshot(&copy); tried += calls; });
+    stop = true;
+    writer.join();
+    benchLine("hist", "snapshot_live", "-", 0, 2, 1, ns, 0, tried ? (double)failed / tried : 0);
+}
+
+static void benchShards(int most)
+{
+    const int adds = 1 << 20; // Per thread per run
+    for (int threads = 1;; threads = threads * 2 > most && threads < most ? most : threads * 2) {
+        for (int shards : { threads, 0 }) {
+            HistShards s(0.01F, 1, 101, DITHER, nullptr, shards);
+            double     best = 1e30;
+            for (int r = 0; r < BENCH_REPS; r++) {
+                std::atomic<int>         ready(0);
+                std::atomic<bool>        go(false);
+                std::vector<std::thread> pool;
+                for (int k = 0; k < threads; k++)
+                    pool.emplace_back([&]() {
+                        ready++;
+                        while (!go.load())
+                            std::this_thread::yield();
+                        for (int i = 0; i < adds; i++)
+                            s.add(benchValue[i & (BENCH_VALUES - 1)]);
+                    });
+                while (ready.load() < threads)
+                    std::this_thread::yield();
+                uint64_t t0 = Chrono::nowNs();
+                go          = true;
+                for (auto &t : pool)
+                    t.join();
+                double ns = (double)(Chrono::nowNs() - t0) / adds;
+                best      = ns < best ? ns : best;
+            }
+            benchLine("shards", shards ? "add" : "add_atomic", "-", 0, threads, 1, best, threads * 1E9 / best);
+        }
+        if (threads >= most)
+            break;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// PUSH AND POP
+//
+
+struct BenchAts // One stream fed at a steady synthetic rate
+{
+    Ats                  ats;
+    int                  channels, samples;
+    std::vector<int32_t> in;
+    std::vector<float>   outF;
+    std::vector<int32_t> outI;
+    double               t = 1E12; // Synthetic ns, past the relative call time range of push and pop
+
+    BenchAts(Mode mode, int channels, int samples) : channels(channels), samples(samples), in(samples * channels), outF(samples * channels), outI(samples * channels)
+    {
+        Config c;
+        c.channels = channels;
+        c.mode     = mode;
+        ats.config(&c);
+        for (size_t k = 0; k < in.size(); k++)
+            in[k] = benchInt32[k & (BENCH_VALUES - 1)];
+    }
+
+    void run(int calls, bool int32, double *pushNs, double *popNs) // Chunks of about 512 samples, timing each side
+    {
+        int chunk = samples >= 512 ? 1 : 512 / samples;
+        *pushNs = *popNs = 0;
+        for (int done = 0; done < calls; done += chunk) {
+            int      n = calls - done < chunk ? calls - done : chunk;
+            double   t1 = t;
+            ats.setDepth(ats.getConfig()->trackTarget);
+            uint64_t t0 = Chrono::nowNs();
+            for (int k = 0; k < n; k++, t += samples * 1E9 / BENCH_RATE)
+                ats.push(samples, channels, 1, in.data(), (int64_t)t);
+            uint64_t tm = Chrono::nowNs();
+            for (int k = 0; k < n; k++, t1 += samples * 1E9 / BENCH_RATE) {
+                if (int32)
+                    ats.pop(samples, channels, 1, outI.data(), (int64_t)t1);
+                else
+                    ats.pop(samples, channels, 1, outF.data(), (int64_t)t1);
+            }
+            uint64_t te = Chrono::nowNs();
+            *pushNs += (double)(tm - t0) - benchClockNs;
+            *popNs += (double)(te - tm) - benchClockNs;
+        }
+        *pushNs /= calls;
+        *popNs /= calls;
+    }
+};
+
+static void benchAts(const char *pushGroup, const char *popGroup, const char *name, Mode mode, int channels, int samples, bool int32)
+{
+    BenchAts b(mode, channels, samples);
+    double   push = 1e30, pop = 1e30, p, q;
+    benchNs([&](int calls) { b.run(calls, int32, &p, &q); push = p < push ? p : push; pop = q < pop ? q : pop; });
+    if (pushGroup != nullptr)
+        benchLine(pushGroup, name, "-", channels, 1, samples, push);
+    benchLine(popGroup, name, int32 ? "int32" : "float", channels, 1, samples, pop);
+}
+
+static const struct { const char *name; Mode mode; } benchInterp[] = {
+    { "HOLD", ATS_INTERP_HOLD }, { "LINEAR", ATS_INTERP_LINEAR }, { "SPLINE3", ATS_INTERP_SPLINE3 }, { "SPLINE5", ATS_INTERP_SPLINE5 }
+};
+
+static void benchMode()
+{
+    const struct { const char *name; Mode flags; } flag[] = {
+        { "", ATS_ZERO_ORDER_HOLD }, { "+TRACKING_OFF", ATS_TRACKING_OFF }, { "+TRACKING_FIXED", ATS_TRACKING_FIXED }
+    }; // Push does not implement the ATS_FILTER modes yet, so they would only time the plain path again
+    for (auto &i : benchInterp)
+        for (auto &f : flag) {
+            char name[64];
+            snprintf(name, sizeof(name), "%s%s", i.name, f.name);
+            benchAts("mode_push", "mode_pop", name, i.mode | f.flags, 2, 64, false);
+        }
+}
+
+static void benchPushPop(const std::vector<int> &channels, const std::vector<int> &samples)
+{
+    for (auto &i : benchInterp)
+        for (int c : channels)
+            for (int s : samples)
+                for (bool int32 : { false, true })
+                    benchAts(int32 ? nullptr : "push", "pop", i.name, i.mode, c, s, int32); // Push is the same for either output
+}
+
+static void benchFilter()
+{
+    const struct { const char *name; uint32_t window, min; } filter[] = {
+        { "fixed", 50, 0 }, { "fixed", 200, 0 }, { "fixed", 512, 0 }, { "adaptive", 200, 50 }, { "adaptive", 512, 50 }
+    };
+    for (auto &f : filter) {
+        Ats    ats;
+        Config c;
+        c.mode       = ATS_INTERP_HOLD;
+        c.filterPush = c.filterPop = f.window;
+        c.filterMin  = f.min;
+        ats.config(&c);
+        int32_t in[2 * 16] = { 0 };
+        float   out[2 * 16];
+        double  t = 1E12;
+        for (uint32_t k = 0; k < f.window; k++, t += 16 * 1E9 / BENCH_RATE) { // Fill both windows with jittered calls
+            ats.push(16, 2, 1, in, (int64_t)(t + benchValue[k & (BENCH_VALUES - 1)] * 100000));
+            ats.pop(16, 2, 1, out, (int64_t)(t + benchValue[(k * 7) & (BENCH_VALUES - 1)] * 100000));
+        }
+        volatile float sink = 0;
+        benchLine("filter", f.name, "-", 0, 1, (int)f.window, benchNs([&](int calls) { for (int i = 0; i < calls; i++) sink = sink + ats.getLatency(); }));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MAIN
+//
+
+static std::vector<int> benchList(const char *s)
+{
+    std::vector<int> v;
+    for (char *e; *s; s = *e ? e + 1 : e) {
+        v.push_back((int)strtol(s, &e, 10));
+        if (e == s)
+            break;
+    }
+    return v;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> channels = { 1, 2, 8, 64, 256 };
+    std::vector<int> samples  = { 1, 16, 64, 256, 1024 };
+    int              threads  = (int)std::thread::hardware_concurrency();
+    std::vector<const char *> groups;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "-t") == 0 && a + 1 < argc)
+            benchMinNs = (uint64_t)(atof(argv[++a]) * 1E6);
+        else if (strcmp(argv[a], "-j") == 0 && a + 1 < argc)
+            threads = atoi(argv[++a]);
+        else if (strcmp(argv[a], "-c") == 0 && a + 1 < argc)
+            channels = benchList(argv[++a]);
+        else if (strcmp(argv[a], "-b") == 0 && a + 1 < argc)
+            samples = benchList(argv[++a]);
+        else if (argv[a][0] == '-') {
+            fprintf(stderr, "usage: ats_bench [-t ms] [-j threads] [-c channels,...] [-b samples,...] [clock|chrono|hist|shards|filter|mode|pushpop ...]\n");
+            return 1;
+        } else
+            groups.push_back(argv[a]);
+    }
+    threads = threads < 1 ? 1 : threads > HIST_SHARDS ? HIST_SHARDS : threads;
+    for (int c : channels)
+        if (c < 1 || c > 256) {
+            fprintf(stderr, "ats_bench: channels %d out of 1..256\n", c);
+            return 1;
+        }
+    for (int s : samples)
+        if (s < 1 || s > 1024) {
+            fprintf(stderr, "ats_bench: samples %d out of 1..1024\n", s);
+            return 1;
+        }
+    auto want = [&](const char *g) {
+        if (groups.empty())
+            return true;
+        for (const char *w : groups)
+            if (strcmp(w, g) == 0)
+                return true;
+        return false;
+    };
+
+    uint32_t r = 1;
+    for (int k = 0; k < BENCH_VALUES; k++) { // Log uniform over 0.01..1 and full scale audio
+        r             = r * 1664525 + 1013904223;
+        benchValue[k] = expf(-4.6F * (float)(r >> 8) * (1.0F / 16777216.0F));
+        benchInt32[k] = (int32_t)r >> 1;
+        benchInt16[k] = (int16_t)(r >> 16);
+    }
+
+    volatile uint64_t sink = 0;
+    benchClockNs           = benchNs([&](int calls) { for (int i = 0; i < calls; i++) sink += Chrono::nowNs(); });
+
+    printf("group,case,output,channels,threads,samples,ns_per_call,ns_per_sample,samples_per_s,fail_rate\n");
+    if (want("clock"))
+        benchClock();
+    if (want("chrono")) {
+        if (!benchBinCheck())
+            return 1;
+        benchChrono();
+    }
+    if (want("hist"))
+        benchHist();
+    if (want("shards"))
+        benchShards(threads);
+    if (want("filter"))
+        benchFilter();
+    if (want("mode"))
+        benchMode();
+    if (want("pushpop"))
+        benchPushPop(channels, samples);
+    return 0;
+}
+
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
@@ -0,0 +1,211 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// ats_replay.cpp
+//
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// FIXED POINT TRACKING REPLAY
+//
+// Checks ATS_TRACKING_FIXED against the float loop on the same offsets.  Pairs of instances, one of each, get the
+// same push and pop calls of a simulated stream - an input clock off by some ppm and late calls by up to some
+// jitter - on a simulated clock source, so all track at the same instants.  The float instance of each pair runs
+// the loop closed.  After each push, where the tracking runs, the fixed instance is compared with the float one
+// and its step then set to the float one, so the pops of both move the same.  Each stream is seeded, so a run is
+// repeatable.
+//
+// The first pair fixes the offset filter windows (filterMin 0), so every update of the fixed loop sees the
+// offsets the float loop saw, and compares the step.  The second pair adapts the windows to the call jitter, in
+// float in one and Q16 in the other, and compares the filtered latency.  The two jitters agree to a few
+// thousandths of a sample, but where one sits on the edge of a window or percentile step the other can land on
+// the next offset along, so the filters differ on a small share of the updates, by the gap to that offset.
+//
+//     ats_replay [-s seconds] [-b lsb]    - 60 simulated seconds per stream, exits 1 beyond 10 LSB of the step
+//                                           or where the filters differ on over 5% of the updates
+//
+// Prints a CSV line per stream of the largest and mean step difference in LSB of the 4.28 step (one LSB is
+// 0.0037 ppm), the rate offset the float loop ended on, the share of updates the filters differ on and the
+// largest difference in samples.
+//
+
+#include "ats.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Audinate::ats;
+
+#define REPLAY_BLOCK 16 // Samples per push and pop
+#define REPLAY_RATE  48000.0
+
+static uint64_t replayClock(void *context) { return *(uint64_t *)context; } // The simulated time
+
+static int64_t replayStep(Ats *ats) { return llround(268435456.0 / ats->getRate()); } // Back to the 4.28 step
+
+struct ReplayResult
+{
+    int64_t updates; // Tracking updates
+    int64_t most;    // Largest difference (LSB)
+    double  sum;     // Sum of the differences over the updates
+    float   ppm;     // Where the float loop ended
+    int64_t differ;  // Updates where the filtered latency differs
+    float   latency; // Largest difference in the filtered latency (samples)
+};
+
+static ReplayResult replay(float ppm, float jitter, bool warp, bool slew, double seconds, uint32_t seed)
+{
+    Ats      ats[4]; // Float and fixed on fixed filter windows, then float and fixed on adaptive windows
+    uint64_t now = (uint64_t)1E12; // Past the relative call time range of push and pop
+    for (int k = 0; k < 4; k++) {
+        Config c;
+        c.channels  = 1;
+        c.mode      = ATS_INTERP_LINEAR | ((k & 1) ? ATS_TRACKING_FIXED : ATS_ZERO_ORDER_HOLD);
+        c.trackWarp = warp ? c.trackWarp : 0;
+        c.trackRate = slew ? c.trackRate : 0;
+        c.filterMin = k < 2 ? 0 : c.filterMin;
+        ats[k].config(&c);
+        ats[k].setDepth(c.trackTarget); // Start on target, as after a trackReset
+        ats[k].setSource(PUSH, replayClock, &now);
+        ats[k].setSource(POP, replayClock, &now);
+    }
+
+    int32_t      in[REPLAY_BLOCK] = { 0 };
+    float        out[REPLAY_BLOCK];
+    double       period = REPLAY_BLOCK * 1E9 / REPLAY_RATE;
+    double       late   = jitter * 1E9 / REPLAY_RATE; // Most a call is late (ns)
+    uint32_t     r      = seed;
+    ReplayResult res    = { 0, 0, 0.0, 0.0F, 0, 0.0F };
+    int64_t      calls  = (int64_t)(seconds * 1E9 / period);
+    for (int64_t n = 0; n < calls; n++) {
+        now               = (uint64_t)(1E12 + n * period);
+        r                 = r * 1664525 + 1013904223;
+        int64_t pushTime  = (int64_t)(1E12 + n * period * (1.0 - ppm * 1E-6) + late * (r >> 8) * (1.0 / 16777216.0));
+        r                 = r * 1664525 + 1013904223;
+        int64_t popTime   = (int64_t)(1E12 + n * period + late * (r >> 8) * (1.0 / 16777216.0));
+        int64_t tracks[2] = { ats[0].chrono(TRACK)->eventCount(), ats[2].chrono(TRACK)->eventCount() };
+        for (int k = 0; k < 4; k++)
+            ats[k].push(REPLAY_BLOCK, 1, 1, in, pushTime);
+        if (ats[0].chrono(TRACK)->eventCount() != tracks[0]) { // A tracking update in the first pair
+            int64_t a = replayStep(&ats[0]), b = replayStep(&ats[1]);
+            int64_t d = a > b ? a - b : b - a;
+            res.updates++;
+            res.sum += (double)d;
+            res.most = d > res.most ? d : res.most;
+            ats[1].setRate(ats[0].getRate()); // Back in step for the pops
+            if (replayStep(&ats[1]) != a)
+                fprintf(stderr, "ats_replay: the step did not carry across exactly\n");
+        }
+        if (ats[2].chrono(TRACK)->eventCount() != tracks[1]) { // And in the second
+            float d     = fabsf(ats[2].getLatency() - ats[3].getLatency());
+            res.differ += d > 1E-4F; // Not just the rounding of the Q8 latency
+            res.latency = d > res.latency ? d : res.latency;
+            ats[3].setRate(ats[2].getRate());
+        }
+        for (int k = 0; k < 4; k++)
+            ats[k].pop(REPLAY_BLOCK, 1, 1, out, popTime);
+    }
+    res.ppm = (float)((ats[0].getRate() - 1.0) * 1E6);
+    return res;
+}
+
+int main(int argc, char **argv)
+{
+    double  seconds = 60;
+    int64_t bound   = 10;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "-s") == 0 && a + 1 < argc)
+            seconds = atof(argv[++a]);
+        else if (strcmp(argv[a], "-b") == 0 && a + 1 < argc)
+            bound = atoi(argv[++a]);
+        else {
+            fprintf(stderr, "usage: ats_replay [-s seconds] [-b lsb]\n");
+            return 1;
+        }
+    }
+
+    const float ppms[]    = { 0.0F, 100.0F, -300.0F };
+    const float jitters[] = { 0.5F, 4.0F, 20.0F };
+    int64_t     most      = 0;
+    double      differ    = 0; // Largest share of updates the adaptive filters differ on
+    uint32_t    seed      = 1;
+    printf("ppm,jitter,warp,slew,updates,max_lsb,mean_lsb,final_ppm,latency_differ,max_latency\n");
+    for (float ppm : ppms)
+        for (float jitter : jitters)
+            for (int shape = 0; shape < 4; shape++) {
+                bool         warp = shape & 1, slew = shape & 2;
+                ReplayResult res  = replay(ppm, jitter, warp, slew, seconds, seed++);
+                double       share = res.updates ? (double)res.differ / res.updates : 0.0;
+                printf("%.0f,%.1f,%d,%d,%lld,%lld,%.2f,%.2f,%.4f,%.3f\n", ppm, jitter, warp, slew, (long long)res.updates, (long long)res.most,
+                       res.updates ? res.sum / res.updates : 0.0, res.ppm, share, res.latency);
+                fflush(stdout);
+                most   = res.most > most ? res.most : most;
+                differ = share > differ ? share : differ;
+            }
+    if (most > bound) {
+        fprintf(stderr, "ats_replay: the fixed loop was %lld LSB from the float loop, beyond %lld\n", (long long)most, (long long)bound);
+        return 1;
+    }
+    if (differ > 0.05) {
+        fprintf(stderr, "ats_replay: the fixed filter differed from the float filter on %.1f%% of the updates\n", differ * 100);
+        return 1;
+    }
+    return 0;
+}
+
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
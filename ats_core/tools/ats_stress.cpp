@@ -0,0 +1,205 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// ats_stress.cpp
+//
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SNAPSHOT STRESS TEST
+//
+// One thread runs push and pop of a fixed block, and alongside them adds to a Histogram and events a Chrono,
+// while another takes snapshots of all three and checks each copy is of one instant.
+//
+//     Ats::snapshot        each call chrono holds a bin count per event after the first (the block size per event
+//                          for the RATE chronos), the EXEC chrono has an event per call, and pop is never ahead of
+//                          push nor more than one behind, as the writer always pushes then pops
+//     Chrono::snapshot     the bins hold one count per event after the first
+//     Histogram::snapshot  the bins add up to the weight
+//
+//     ats_stress [seconds]    - 2 seconds by default, exits 1 if any copy was torn
+//
+// A snapshot that finds no clean copy in its tries is counted but is not an error.  On one core most of those are
+// the writer being switched out part way through an update.
+//
+
+#include "ats.h"
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+using namespace Audinate::ats;
+
+#define STRESS_BLOCK 16 // Samples per push and pop
+
+struct Stress
+{
+    Ats               ats;
+    Chrono            chrono;
+    Histogram         hist;
+    std::atomic<bool> stop{ false };
+};
+
+static void stressWriter(Stress *s)
+{
+    int32_t in[STRESS_BLOCK * 2] = { 0 };
+    float   out[STRESS_BLOCK * 2];
+    double  t = 1E12; // Synthetic call times at 48kHz
+    for (int i = 0; !s->stop.load(std::memory_order_relaxed); i++, t += STRESS_BLOCK * 1E9 / 48000) {
+        s->ats.push(STRESS_BLOCK, 2, 1, in, (int64_t)t);
+        s->ats.pop(STRESS_BLOCK, 2, 1, out, (int64_t)t);
+        s->chrono.event();
+        s->hist.add((float)(i % 100));
+    }
+}
+
+static HistTotal<HistType> stressBins(Chrono *c) // Sum of the bins as the histogram gives them
+{
+    Histogram h;
+    c->histogram(&h);
+    HistTotal<HistType> n = 0;
+    for (int b = 0; b < h.bins(); b++)
+        n += h.bin(b);
+    return n;
+}
+
+static int stressAts(Chrono *c) // Violations in one copy of the Ats chronos
+{
+    int     bad = 0;
+    int64_t events[EVENTS];
+    for (int e = 0; e < EVENTS; e++)
+        events[e] = c[e].eventCount();
+    const struct { Event e; int64_t count; } call[] = {
+        { PUSH, 1 }, { PUSH_RATE, STRESS_BLOCK }, { PUSH_EXEC, 1 }, { POP, 1 }, { POP_RATE, STRESS_BLOCK }, { POP_EXEC, 1 }
+    };
+    for (auto &k : call) {
+        HistTotal<HistType> n = stressBins(&c[k.e]);
+        if (events[k.e] > 0 && (int64_t)n != (events[k.e] - 1) * k.count) {
+            fprintf(stderr, "ats_stress: event %d has %lld in the bins for %lld events\n", (int)k.e, (long long)n, (long long)events[k.e]);
+            bad++;
+        }
+    }
+    if (events[PUSH_EXEC] != events[PUSH] || events[POP_EXEC] != events[POP] || events[POP] > events[PUSH] || events[POP] < events[PUSH] - 1) {
+        fprintf(stderr, "ats_stress: push %lld exec %lld pop %lld exec %lld are not one epoch\n", (long long)events[PUSH], (long long)events[PUSH_EXEC],
+                (long long)events[POP], (long long)events[POP_EXEC]);
+        bad++;
+    }
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    Stress s;
+    Config c;
+    c.channels = 2;
+    s.ats.config(&c);
+    s.chrono.config(0, 0.0001F, 101, DITHER);
+    s.hist.config(0, 99, 100, NONE);
+
+    static Chrono chronos[EVENTS];
+    static uint32_t storage[ATS_CHRONO_POOL];
+    Chrono    chrono;
+    Histogram hist;
+    long      copies[3] = { 0 }, missed[3] = { 0 }, torn[3] = { 0 };
+
+    std::thread writer(stressWriter, &s);
+    uint64_t    end = Chrono::nowNs() + (uint64_t)(seconds * 1E9);
+    while (Chrono::nowNs() < end) {
+        if (s.ats.snapshot(chronos, storage)) {
+            copies[0]++;
+            torn[0] += stressAts(chronos) > 0;
+        } else
+            missed[0]++;
+
+        if (s.chrono.snapshot(&chrono) >= 0) {
+            copies[1]++;
+            int64_t events = chrono.eventCount();
+            if (events > 0 && (int64_t)stressBins(&chrono) != events - 1) {
+                fprintf(stderr, "ats_stress: chrono has %lld in the bins for %lld events\n", (long long)stressBins(&chrono), (long long)events);
+                torn[1]++;
+            }
+        } else
+            missed[1]++;
+
+        if (s.hist.snapshot(&hist)) {
+            copies[2]++;
+            HistTotal<HistType> n = 0;
+            for (int b = 0; b < hist.bins(); b++)
+                n += hist.bin(b);
+            if (n != hist.n()) {
+                fprintf(stderr, "ats_stress: histogram has %lld in the bins for a weight of %lld\n", (long long)n, (long long)hist.n());
+                torn[2]++;
+            }
+        } else
+            missed[2]++;
+    }
+    s.stop = true;
+    writer.join();
+
+    const char *name[3] = { "Ats", "Chrono", "Histogram" };
+    long        bad     = 0;
+    for (int k = 0; k < 3; k++) {
+        printf("%-10s %9ld copies %9ld without a clean copy %6ld torn\n", name[k], copies[k], missed[k], torn[k]);
+        bad += torn[k];
+    }
+    return bad > 0;
+}
+
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
@@ -65,7 +65,7 @@
 //
 // To manage precision timing with counter resolution and potentially long times, we use 64bit representations
 // of counters.  It is required that this counter have a fixed frequency.
-// The bins are uint32 so a limit of 4 billion events per time bin.
+// The bins of Chrono are uint32 so a limit of 4 billion events per time bin - ChronoOf takes other bin types.
 // The overall event count is 64 bit to enable any overflow to be detected.
 // Bin widths are limited to uni32_t which is 400s for the 100ns typical timer.
 //
@@ -74,6 +74,15 @@
 // width and number of bins.  The width must be integral so the range of the histogram will be quantized
 // at very high resolution time binning.  Data use is around 40 bytes plus the histogram bins (int32_t).
 //
+// Where a wide range has to be held at a fixed relative precision, configLogLin sets up log-linear bins in the
+// style of HDR histograms.  These are exact up to a few times the lowest value and then hold the requested
+// significant digits to the highest, without dither.  This takes more bins than the 101 held inline, so the
+// caller can provide the storage, which is referenced by offset so it may share a memory mapping with the chrono.
+//
+// For a view of recent behaviour alongside the lifetime, configWindows adds a ring of sub-histograms each
+// covering a fixed period.  Every update also lands in the current window, and the writer moves on to the next,
+// clearing it, once the period is up.  Queries sum the current window or the last few complete ones.
+//
 #pragma once
 #include "hist.h"
 #include <stdint.h>
@@ -81,6 +90,8 @@
 
 namespace Audinate { namespace chrono {
 
+#define CHRONO_WINDOW_BINS 2048 // Most bins a windowed chrono can have
+
 using namespace Audinate::hist;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -94,37 +105,90 @@ using namespace Audinate::hist;
 // chronoConfig function due to rounding or optimizations.  Access the data using the hist
 // mapping rather than assume anything in the setup.
 //
+// Time comes from the process clock set by setClock, unless a chrono is given its own source.  A source is a
+// function returning ns with a context pointer, so it can be one of the built in clocks from source(), or a
+// user clock such as a PTP disciplined media clock or a simulated time for testing.  It must be monotonic, and
+// any times passed in to the updaters must be on the same source.
+//
+// TSC refreshes its calibration against MONO once a second, and by default that is done inline by whichever read
+// finds it due, so one read a second on some thread, possibly the audio one, takes about half a microsecond more
+// (ten clock reads).  To keep it off the audio thread, call calibrate from a non real time thread at least once
+// a second - each call moves the next refresh a second on, so the readers never find it due.
+//
 
-struct chrono_t;          // Abstract the implementation
-enum   chrono_clock   { MONO = CLOCK_MONOTONIC_RAW, REALTIME = CLOCK_REALTIME, TAI = CLOCK_TAI };
+template <typename B, int Bins> struct chrono_t; // Abstract the implementation
+typedef uint64_t (*ChronoSource)(void *context); // A clock source in ns
+enum   chrono_clock   { MONO = CLOCK_MONOTONIC_RAW, REALTIME = CLOCK_REALTIME, TAI = CLOCK_TAI, TSC = 0x7FFF }; // TSC is MONO time read from the cycle counter
 
-class Chrono
+class ChronoBase // The process clock, shared by chronos of every bin type
 {
   public:
     static uint64_t nowNs(); // Return the full time in ns - cast to uint32 to get the 32 bit rolling
     static timespec now();   // Return now at same offset used by the current chrono timer
     static chrono_clock getClock() { return clock; };             // Return the ID of the timer for this process
-    static void         setClock(chrono_clock c) { clock = c; };  // Set the ID of the timer for this process
+    static void         setClock(chrono_clock c);                 // Set the ID of the timer for this process - TSC falls back to MONO if not invariant
+    static bool         calibrate();                              // Refresh the TSC calibration against MONO, once TSC is in use - else its reads do it inline once a second
+    static ChronoSource source(chrono_clock c);                   // Built in source for a clock - TSC falls back to MONO if not invariant
+    static int          bin(int64_t offset, uint32_t width, int bins); // Bin of an offset from the first bin for a linear config, before dither
 
-    Chrono();
-    Chrono(float bin0, float binN, int bins=101, HistFlag flags=HistFlag::DITHER, const char* name=nullptr) : Chrono() { this->config(bin0,binN,bins,flags,name); }
-    ~Chrono();
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Versions
+    static unsigned int versionMajor();
+    static unsigned int versionMinor();
+    static unsigned int versionPatch();
+    static const char * versionSuffix();
+    static const char * versionHash();
+    static const char * versionFull();
+
+  private:
+    static chrono_clock clock;                      // The clock to use for this process - should only set once
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BIN STORAGE
+// As for HistogramOf, the bins are of type B with at most Bins held inline, and the histogram given to the
+// accessors has the same bins.  Chrono is the default of uint32_t and 101 bins.  The implementation is instanced
+// at the foot of chrono.cpp for the same types and sizes as the histograms.
+//
+template <typename B = HistType, int Bins = HIST_BINS> class ChronoOf : public ChronoBase
+{
+  public:
+    ChronoOf();
+    ChronoOf(float bin0, float binN, int bins=Bins, HistFlag flags=HistFlag::DITHER, const char* name=nullptr) : ChronoOf() { this->config(bin0,binN,bins,flags,name); }
+    ~ChronoOf();
 
     bool config(
         float       bin0,                          // The centre of the first bin (s)
         float       binN,                          // The centre of the last bin (s)
-        int         bins  = 101,                   // The number of bins to accumulate into, must be even - for example for 4 bins
+        int         bins  = Bins,                  // The number of bins to accumulate into, must be even - for example for 4 bins
         HistFlag    flags = HistFlag::DITHER,      // Additional flags, shared with hist
         const char *name  = nullptr);               // Optional name
-    void reset();                                  // Reset without changing the config - use sparingly
-    void event(uint64_t nowNs = 0, int count = 1); // Register an event, creating histogram of the time gaps
-    void count(int val, int count = 1);            // Register a value, creating histogram of the values
-    void restart();                                // Reset the last time so we can count a discontinuous interval
+    bool configLogLin(
+        float       lowest,                        // The smallest value held at full resolution (s) - rounded to a power of 2 ns
+        float       highest,                       // The largest value before saturating into the last bin (s)
+        int         digits      = 2,               // Significant decimal digits held across the range (1..3)
+        HistFlag    flags       = HistFlag::NONE,  // COUNTER may be set for values rather than times
+        const char *name        = nullptr,         // Optional name
+        B *         storage     = nullptr,         // Bins to use in place of those inline - must outlive the chrono config
+        int         storageBins = 0);              // Size of the storage, any bins beyond this saturate into the last
+    static int logLinBins(float lowest, float highest, int digits = 2, HistFlag flags = HistFlag::NONE); // Bins to cover the range
+    bool configWindows(
+        int         windows,                       // Windows in the ring, at least 2 as one is always filling - 0 turns windows off
+        float       period,                        // Time each window covers (s) on the clock of this chrono
+        B *         storage,                       // The window bins - must outlive the config, and a later config drops the windows
+        int         storageBins);                  // Size of the storage, windows times the bins configured
+    void reset();                                                  // Reset without changing the config - use sparingly
+    void event(uint64_t nowNs = 0, int count = 1, int weight = 1); // Register an event, creating histogram of the time gaps
+    void count(int val, int count = 1, uint64_t nowNs = 0);        // Register a value, creating histogram of the values
+    void add(int val, int count = 1);                              // As count, but leaves the time alone - no clock read, so sinceNs and periodNs do not follow it
+    void restart(uint64_t nowNs = 0);                              // Reset the last time so we can count a discontinuous interval
+    void setSource(ChronoSource source = nullptr, void *context = nullptr); // Clock for this chrono - nullptr for the process clock
 
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // FUNCTIONS FOR ACCESSING THE DATA - PLATFORM INDEPENDENT
     //
-    // Note that these timespecs are not necessarily offset from any origin
+    // Note that these timespecs are not necessarily offset from any origin.  Wherever a nowNs is taken, 0 reads
+    // the clock, so a caller making several updates in one pass can read the clock once and share it.
 
     int32_t configCount(); // Number of time it has been reset/configured
     int64_t eventCount();  // The number of events - use to bracket valid read
@@ -132,9 +196,10 @@ class Chrono
     timespec startTime(); // Return time the last config/reset occurred
     timespec lastTime();  // Return the last event time
 
-    int64_t diffNs();   // Return the last time difference between events (ns)
-    int64_t sinceNs();  // Return the time since the event last happened without triggering event
-    int64_t periodNs(); // Return the longtime average period (ns)
+    int64_t diffNs();                    // Return the last time difference between events (ns)
+    int64_t sinceNs(uint64_t nowNs = 0); // Return the time since the event last happened without triggering event
+    uint64_t sourceNs();                 // Now on the clock source of this chrono
+    int64_t periodNs();                  // Return the longtime average period (ns)
 
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // ACCESSING THE HISTOGRAM
@@ -142,25 +207,28 @@ class Chrono
     // For this we use hist.  This method will use an existing histogram instance doing a configure
     // which will resize any internal storage if needed.
     //
-    void histogram(Histogram *h);
+    void histogram(HistogramOf<B, Bins> *h);                              // The lifetime since the last config or reset
+    bool histogram(HistogramOf<B, Bins> *h, int windows, int tries = 100); // The current window if 0, else the last complete ones
+    int32_t windowCount();                                     // Complete windows held - fewer than asked for are summed
 
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    // Versions
-    static unsigned int versionMajor();
-    static unsigned int versionMinor();
-    static unsigned int versionPatch();
-    static const char * versionSuffix();
-    static const char * versionHash();
-    static const char * versionFull();
+    // CONSISTENT SNAPSHOT
+    //
+    // The accessors above read the live chrono and can see an update part done.  Snapshot copies it as of one
+    // instant without ever blocking the writer, retrying if an update or reset lands during the copy.  Use the
+    // copy for the accessors and histogram.  Log-linear bins held outside the chrono need storage for the copy.
+    //
+    int snapshot(ChronoOf *copy, B *storage = nullptr, int storageBins = 0, int tries = 100); // Storage bins used, -1 if none clean
 
   private:
     uint32_t rand();                                // A 32 bit random number seeded within this chrono - may optimize to nothing
-    static chrono_clock clock;                      // The clock to use for this process - should only set once
-    char mData[64 + 4 + 4 + 8 + 8 + 8 + 8 + 8 + 4 + 4 + 101 * 4 + 4];
+    char mData[64 + 4 + 4 + 8 + 8 + 8 + 8 + 8 + 4 + 4 + 8 + 4 + 4 + 8 + 8 + 8 + 8 + 8 + 8 + 4 + 4 + 4 + 4 + Bins * sizeof(B) + 4 + 4 + 4 + 8]; // 8 for alignment
     // @Alan - is there a convenient way of doing this without exposing struct?
     // Note that the config has an assert to ensure this is correct size
 };
 
+typedef ChronoOf<> Chrono;
+
 }} // namespace Audinate::chrono
 
 //
@@ -84,6 +84,10 @@
 // from centre to centre is (bins-1)*width.  This creates simple computation for the bin centres as
 // bin0+n*width and the edges are n+-1/2
 //
+// Histograms combine with merge, so one can pool many instances, and subtract, to give the change since an
+// earlier copy.  With the same bins this is exact, otherwise the counts of each bin are shared over the bins it
+// overlaps in proportion.  The count, sums, min and max carry across.
+//
 // Overflows will be accumulated into the first and last bins.  So if you want to track underflows separately
 // then extend the range to add two more bins and suiable centres just past your desired uncorrupted range.
 //
@@ -104,8 +108,7 @@
 //
 // A read/copy of a histogram bins always represents a valid sample of things, unless another user clears
 // the histogram during a read.  The precise sum and sum^2 may be inconsistent if an add occurs duing
-// use of them.  If either of these concerns is critical, then use the consistent 'copy' prior to getting
-// any statistics, or explicitly make sure a *(volatile int*)&p->configs does not change across calculation.
+// use of them.  If either of these concerns is critical, then take a snapshot prior to getting any statistics.
 //
 // The system is designed to be very statistically unbiased - such that when there is not over flow in the
 // bin range then the true mean and variance are unbiased and efficient to within sample size and the
@@ -120,16 +123,26 @@ namespace Audinate { namespace hist {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // STORAGE TYPE FOR EACH BIN
-// Generally will be an int.  Can be char if memory sensitive or float if accumulating continuous measures.
+// Generally will be an int.  HistogramOf takes the bin type and the most bins it holds, so uint16_t suits many small
+// instances, uint64_t long running counters and float weighted data.  The totals of uint16_t bins are held as
+// uint32_t.  Histogram is the default of uint32_t and 101 bins.  The implementation is instanced at the foot of
+// hist.cpp for each type with 101 bins, uint16_t with 32 and uint32_t with 1001 - add a line there for any other.
 //
 typedef uint32_t HistType;
 
+#define HIST_BINS 101 // Bins held by the default Histogram
+
+template <typename B> struct HistTotalOf { typedef B type; };          // Totals are held in the bin type
+template <> struct HistTotalOf<uint16_t> { typedef uint32_t type; };   // except for the small bins that would soon wrap
+template <typename B> using HistTotal = typename HistTotalOf<B>::type; //
+
 enum HistFlag : int
 {
     NONE    = 0x00000000, // Default of no flags
     DITHER  = 0x00000001, // The entries are dithered before being placed into bins - removes bias but lowers resolution
     COUNTER = 0x00000002, // The value arguments are strictly integers
     LOGX    = 0x00000004, // The bins are spaced logarithmically in the x axis
+    LOGLIN  = 0x00000008, // Chrono only - log-linear (HDR) bins, linear within each octave - see Chrono::configLogLin
 
 };
 inline HistFlag operator|(HistFlag a, HistFlag b) { return (HistFlag)((int)a | (int)b); };
@@ -160,19 +173,38 @@ inline HistTextOption operator|(HistTextOption a, HistTextOption b) { return (Hi
 inline HistTextOption operator&(HistTextOption a, HistTextOption b) { return (HistTextOption)((int)a & (int)b); };
 inline HistTextOption operator~(HistTextOption a) { return (HistTextOption)(~(int)a); };
 
+#define HIST_PERCENTS 8 // Most percentiles one call to stats gives
+
+template <typename B = HistType> struct HistStatsOf // Everything from one pass over the bins - each as the accessor of the same name
+{
+    HistTotal<B> n;   // As n(cull)
+    float    sum;     // As sum(cull)
+    float    mean;    // As mean(), or binMean(cull) if culled
+    float    std;     // As std(), or binStd(cull) if culled
+    float    binMean; // As binMean(cull)
+    float    binStd;  // As binStd(cull)
+    float    min;     // As min()
+    float    max;     // As max()
+    float    median;  // As median(cull)
+    float    mode;    // As mode(cull)
+    B        peak;    // As peak(cull)
+    float    percent[HIST_PERCENTS]; // As percent(percents[k], cull) for each asked for
+};
+typedef HistStatsOf<> HistStats;
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // HISTOGRAM CONFIGURATION MANAGEMENT AND UPDATE
 //
-struct hist_t;
+template <typename B, int Bins> struct hist_t;
 
-class Histogram
+template <typename B = HistType, int Bins = HIST_BINS> class HistogramOf
 {
   public:
-    Histogram();
-    Histogram(float bin0, float binN, int bins=100, HistFlag flags=HistFlag::DITHER, const char *name = nullptr) : Histogram()
+    HistogramOf();
+    HistogramOf(float bin0, float binN, int bins=100, HistFlag flags=HistFlag::DITHER, const char *name = nullptr) : HistogramOf()
     { this->config(bin0, binN, bins, flags, name); };
 
-    ~Histogram();
+    ~HistogramOf();
 
     bool config(
         float       bin0,                     // The centre of the first bin
@@ -182,16 +214,25 @@ class Histogram
         const char *name  = nullptr           // Optional name)
     );
     void reset();                      // Reset without changing the config
-    void add(float x, HistType n = 1); // Low overhead call for each event
+    void add(float x, B n = 1);              // Low overhead call for each event
+    void addAtomic(float x, B n = 1);        // As add, but safe with other writers - at the cost of atomic updates
+    void add(const float *x, int count);     // Each of a block of values with n = 1 - cheaper per value for signal statistics
+    void add(const int32_t *x, int count);   // As above for integer samples
+    void add(const int16_t *x, int count);   //
 
     bool reconfig(
         float       bin0,
         float       binN,
         int         bins,
         HistFlag    flags,
-        uint32_t *  bin, // Existing set of data to work from
+        B *         bin, // Existing set of data to work from
         const char *name = nullptr);
 
+    bool snapshot(HistogramOf *copy, int tries = 100) const; // Consistent copy without blocking add - false if none clean in the tries
+    bool merge(const HistogramOf *h, int tries = 100);      // Add in the counts of another, rebinned if the bins differ - or copy it if not configured
+    bool subtract(const HistogramOf *h, int tries = 100);   // Take out the counts of an earlier copy of this - false unless compatible
+    bool compatible(const HistogramOf *h) const;            // Same bins, so merge and subtract are exact
+
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // DATA EXTRACTION FUNCTIONS
     //
@@ -207,28 +248,30 @@ class Histogram
     // again the same as there being data in the edge bins.
     //
     // Much of this complexity is abstracted from the user in these functions which all endeavour to return the most
-    // unbiased value available given the structure and logging underneath.
+    // unbiased value available given the structure and logging underneath.  Where several are wanted, stats gives
+    // them all from a single pass over the bins.
     //
 
     HistFlag flags() const;                 // Things like dither enabled and log scaling options
-    HistType n(bool cull = false) const;    // Either the internal cumulative total (N) or the bin sum excluding edges
+    HistTotal<B> n(bool cull = false) const; // Either the internal cumulative total (N) or the bin sum excluding edges
     float    sum(bool cull = false) const;  // Either the internal cumulative sum (sumX) or the bin cumulative sum excluding edges
     float    mean() const;                  // Most unbiased mean - sumX / N
     float    std() const;                   // Most unbiased standard deviation - sqrt(sumX2/N - u^2)
     float    max() const;                   // X value of right edge of maximum non zero bin
     float    min() const;                   // X value of left  edge of minimum non zero bin
-    HistType peak(bool cull = false) const; // Peak value across all bins - useful for scaling
+    B        peak(bool cull = false) const; // Peak value across all bins - useful for scaling
 
     float binMean(bool cull = false) const;                // Option to remove outlier bins (first and last)
     float binStd(bool cull = false) const;                 // Option to remove outlier bins (first and last)
     float median(bool cull = false) const;                 // Median
     float percent(float percent, bool cull = false) const; // Median is 50% percentile
     float mode(bool cull = false) const;                   // Location of the peak using
+    bool  stats(HistStatsOf<B> *s, bool cull = false, const float *percents = nullptr, int count = 0) const; // All of the above in one pass
 
     float    binCenter(int bin) const; // Return the centre value of a bin
     float    binWidth() const;         // Return the width of a bin
     int      bins() const;             // Return number of bins
-    HistType bin(int bin) const;       // Return the bin value - not allowing direct access to buffer
+    B        bin(int bin) const;       // Return the bin value - not allowing direct access to buffer
 
     bool text(                                                     // Create a text representation of a histogram
         int            barHeight,                                  // Will be this many characters high
@@ -248,11 +291,13 @@ class Histogram
     static const char * versionFull();
 
   private:
-    char mData[64 + 4 + 4 + 4 + 4 + 4 + 4 + 101 * 4 + 4 + 4 + 4 + 4 + 4 + 4];
+    char mData[64 + 4 + 4 + 4 + 4 + 4 + 4 + Bins * sizeof(B) + 4 + sizeof(HistTotal<B>) + 4 + 4 + 4 + 4 + 4 + 4 + 4 + 8]; // 8 for alignment
     // @Alan - is there a convenient way of doing this without exposing struct?
     // Note that the config has an assert to ensure this is correct size
 };
 
+typedef HistogramOf<> Histogram;
+
 }} // namespace Audinate::hist
 
 //
@@ -0,0 +1,129 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// hist2d.h
+//
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TWO DIMENSIONAL HISTOGRAM
+//
+// For how one measure goes with another - such as the execution time of a call against the samples it handled,
+// or the latency against the offset - Histogram2D counts pairs into a grid of cells.  Each axis is configured as
+// a Histogram is, with its own range, bins and flags, so DITHER and LOGX act on each axis independently.  COUNTER
+// marks an axis of whole numbers, so its bins are made a whole number wide and each value lands in one bin.
+//
+// The grid is held inline, up to HIST2D_CELLS cells and at most HIST_BINS along an axis, so that marginal can
+// sum along either axis back into a Histogram for the existing tools, optionally over a band of the other axis.
+// The exact sums of each value, their squares and their product are kept for the means and the correlation.
+//
+// As for Histogram it has a single writer, and snapshot, marginal and correlation read it between two even and
+// unchanged reads of the sequence counters, so any other thread may read it without blocking the writer.
+//
+#pragma once
+#include "hist.h"
+#include <stdint.h>
+
+namespace Audinate { namespace hist {
+
+#define HIST2D_CELLS 1024 // Most cells - 32 x 32 or any other shape within it
+
+enum HistAxis : int
+{
+    AXIS_X = 0,
+    AXIS_Y = 1
+};
+
+struct hist2d_t; // Abstract the implementation
+
+class Histogram2D
+{
+  public:
+    Histogram2D();
+    ~Histogram2D();
+
+    bool config(
+        float       x0,                   // The centre of the first bin of x
+        float       xN,                   // The centre of the last bin of x
+        int         xBins,                // The number of bins along x
+        HistFlag    xFlags,               // DITHER, LOGX and COUNTER for x
+        float       y0,                   // As above for y
+        float       yN,                   //
+        int         yBins,                //
+        HistFlag    yFlags,               //
+        const char *name = nullptr);      // Optional name
+    void reset();                         // Reset without changing the config
+    void add(float x, float y, HistType n = 1); // Low overhead call for each pair
+
+    bool snapshot(Histogram2D *copy, int tries = 100) const; // Consistent copy without blocking add - false if none clean in the tries
+    bool marginal(Histogram *h, HistAxis axis, int from = 0, int to = -1, int tries = 100) const; // Sum over bins from..to of the other axis - -1 for the last
+    float correlation(int tries = 100) const;                // Of the exact values, logged on a LOGX axis - 0 if fewer than two or constant
+
+    HistType    n() const;                        // Sum of the weights added
+    int         bins(HistAxis axis) const;        // Along an axis
+    int         bin(HistAxis axis, float v) const; // The bin of a value along an axis
+    float       binCenter(HistAxis axis, int bin) const; // Return the centre value of a bin
+    float       mean(HistAxis axis) const;        // Of the exact values - geometric for LOGX
+    HistType    cell(int x, int y) const;         // Return the cell value - not allowing direct access to buffer
+    const char *name() const;                     //
+
+  private:
+    char mData[64 + 4 + 4 + 2 * (4 + 4 + 4 + 4 + 4) + 4 + 4 + 4 + 4 + 8 + 8 + 8 + 8 + 8 + HIST2D_CELLS * 4];
+    // Note that the constructor has an assert to ensure this is correct size
+};
+
+}} // namespace Audinate::hist
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
@@ -0,0 +1,114 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// metrics.h
+//
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// OPENMETRICS EXPORT
+//
+// Renders histograms and chronos as OpenMetrics (Prometheus) text.  A histogram becomes cumulative _bucket lines
+// with the upper edge of each bin as le, the last bin as +Inf, and _count and _sum, or a summary gives the 0.5,
+// 0.9 and 0.99 quantiles with _count and _sum.  The sum is taken from the bin centres, so it is to the bin
+// resolution.  A histogram holding negative values, such as a rate offset, has only the buckets, and a summary
+// of one only the quantiles.
+//
+// OpenMetrics needs all the samples of a family together, so write family once and then each instance of it,
+// with labels to tell them apart.  The text goes into the buffer given at construction, which with a file
+// descriptor is written out each time it fills, so one small buffer serves any size of export.  Without one, a
+// line that does not fit is dropped and overflow is set.  The scratch histogram and chrono copy are held inside,
+// so an export does no allocation and a background thread can keep one Metrics to reuse for each scrape.
+//
+#pragma once
+#include "chrono.h"
+#include "hist.h"
+#include <stdint.h>
+
+namespace Audinate { namespace chrono {
+
+#define METRICS_POOL (1024) // Log-linear bins a chrono copy can hold
+
+struct metrics_t; // Abstract the implementation
+
+class Metrics
+{
+  public:
+    Metrics(char *buffer, int size, int fd = -1); // Text goes into buffer - with an fd it is written out when full
+    ~Metrics();
+
+    void family(const char *name, const char *type, const char *help = nullptr, const char *unit = nullptr); // TYPE, UNIT, HELP
+    void histogram(const char *name, const Histogram *h, const char *labels = nullptr, bool sparse = true); // One instance
+    void histogram(const char *name, Chrono *c, const char *labels = nullptr, bool sparse = true);          // Via a snapshot
+    void summary(const char *name, const Histogram *h, const char *labels = nullptr);
+    void summary(const char *name, Chrono *c, const char *labels = nullptr);
+    void gauge(const char *name, double value, const char *labels = nullptr);
+    void eof(); // The # EOF that ends an exposition
+
+    int         flush();     // Write the text out to the fd and empty the buffer - bytes written or -1
+    void        clear();     // Empty the buffer and clear overflow
+    const char *text();      // The text so far - null terminated
+    int         length();    // Bytes of text so far
+    bool        overflow();  // A line was dropped for want of space
+
+    static int label(char *str, int size, const char *name, const char *value); // Append name="value", escaped - new length
+
+  private:
+    char mData[8 + 4 + 4 + 4 + 4 + sizeof(Histogram) + sizeof(Chrono) + METRICS_POOL * 4 + 4];
+    // Note that the constructor has an assert to ensure this is correct size
+};
+
+}} // namespace Audinate::chrono
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
@@ -0,0 +1,115 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// perf.h
+//
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// HARDWARE PERFORMANCE COUNTERS
+//
+// Wall clock chronos show that a call was slow, but not whether it missed the cache, mispredicted or was switched
+// out.  Perf opens a set of hardware counters for the calling thread through the Linux perf_event_open interface
+// and records how far each moves across a begin and end into a chrono, so the counts are histograms of the
+// cycles, instructions, misses and context switches per call on the same hist access as the timing.
+//
+// The counters are opened as one group and read with a single system call at each of begin and end, which costs
+// most of a microsecond, so this is a diagnostic to enable while looking rather than leave on.  Open must be done
+// on the thread to be measured.  Counters the platform does not have are left out, and where there are none at
+// all (not Linux, no PMU in a virtual machine, perf_event_paranoid too high) open returns false and begin and end
+// do nothing.  Only user space is counted where the kernel will not allow more.
+//
+#pragma once
+#include "chrono.h"
+#include <stdint.h>
+
+namespace Audinate { namespace chrono {
+
+enum perf_counter
+{
+    CYCLES,           // CPU cycles
+    INSTRUCTIONS,     // Instructions retired
+    L1D_MISSES,       // Level 1 data cache read misses
+    LLC_MISSES,       // Last level cache misses
+    CONTEXT_SWITCHES, // Times the thread was switched out
+    PERF_COUNTERS
+};
+
+struct perf_t; // Abstract the implementation
+
+class Perf
+{
+  public:
+    Perf();
+    ~Perf();
+
+    bool open(const char *name = nullptr); // Open the counters for the calling thread - false if none are available
+    void close();                          // Close the counters, keeping the histograms
+    bool available(perf_counter c = PERF_COUNTERS); // Whether a counter (or any with PERF_COUNTERS) was opened
+    void reset();                          // Reset the histograms
+
+    void begin();              // Read the counters at the start of the section
+    void end(int weight = 1);  // Read again and record the differences - weight as for Chrono::event
+
+    Chrono *chrono(perf_counter c); // Histogram of the counts per section
+
+  private:
+    char mData[PERF_COUNTERS * (sizeof(Chrono) + 4 + 4 + 8) + 4 + 4 + 8 + 8 + 8 + 928 * 4];
+    // Note that the constructor has an assert to ensure this is correct size
+};
+
+}} // namespace Audinate::chrono
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
\ No newline at end of file
@@ -0,0 +1,142 @@
+//
+// AUDIO TEMPORAL STRETCHER CODE LICENSE
+//
+// PERMISION NOTICE
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+// record.h
+//
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// HISTOGRAM RECORDING
+//
+// Recorder keeps a time series of chronos in an append only file so their distributions can be looked back over
+// after a glitch, hours later.  Each sample appends one frame holding only the bins that changed since the last,
+// as the increase in each, with the gaps between changed bins and the counts packed as varints.  A chrono seen
+// for the first time, or after a reset or config, gets a key frame with all of its bins, and again after
+// keyFrames changes.  Chronos that have not changed write nothing, and a sample where none have writes nothing.
+//
+// The bins are those of Chrono::histogram, so log-linear chronos are recorded on their 101 bin rebinning, and
+// each chrono is copied by snapshot first so this is safe from any thread.  There is no thread inside - the
+// caller runs sample from its own background thread or timer, every second or so.  A frame is written with a
+// single write, so a crash at worst leaves a part frame at the end, which the reader ignores.
+//
+// The file starts with a 16 byte header and then frames of
+//     varint length, varint time ns, records...
+// where a record is a varint tag and then
+//     SESSION                                    A recorder opened the file - names are given again after it
+//     NAME  id, length, name                     The id of a series for the rest of the session
+//     KEY   id, configs, flags, bins, bin0, binN, bins x count     bin0 and binN are raw floats
+//     DELTA id, changed, changed x (gap, increase)                gap is from the bin after the last changed
+//
+// Recording maps the file read only and reconstructs a series, by name, as it stood at any time recorded, or the
+// change between two times for what happened in an interval - from the reset if the chrono was reset or the
+// recorder restarted in between.  The file can be read while it is being written, and refresh maps the frames
+// added since.
+//
+#pragma once
+#include "chrono.h"
+#include "hist.h"
+#include <stdint.h>
+
+namespace Audinate { namespace chrono {
+
+#define RECORD_POOL  (1024) // Log-linear bins a chrono copy can hold
+#define RECORD_MAGIC (0x52524843) // "CHRR" at the start of a recording
+
+struct recorder_t;  // Abstract the implementation
+struct recording_t;
+
+class Recorder
+{
+  public:
+    Recorder();
+    ~Recorder();
+
+    bool open(const char *path, int series = 64, int keyFrames = 3600); // Create the file or append to it - false on error
+    void close();
+    bool add(Chrono *c, const char *name);  // Record a chrono under a name, unique in the file - false if full
+    void remove(const Chrono *c);           // Stop recording a chrono - before it goes away
+    int  sample(uint64_t timeNs = 0);       // Append a frame of the changes - bytes written or -1, time 0 for realtime now
+    int64_t bytes();                        // Written since open
+
+  private:
+    char mData[8 + 8 + 8 + 4 + 4 + 4 + 4 + sizeof(Histogram) + sizeof(Chrono) + RECORD_POOL * 4 + 8];
+    // Note that the constructor has an assert to ensure this is correct size
+};
+
+class Recording
+{
+  public:
+    Recording();
+    ~Recording();
+
+    bool open(const char *path); // Map a recording read only - false if it is not one
+    void close();
+    bool refresh();              // Map again to take in frames appended since
+
+    int      frames();                              // Complete frames in the file
+    uint64_t frameNs(int frame);                    // Time of a frame - 0 if there is no such frame
+    int      series(int n, char *name, int size);   // Name of the nth distinct series - its length, or -1 past the end
+    bool     histogram(const char *name, uint64_t timeNs, Histogram *h);                // As of the last frame at or before
+    bool     histogram(const char *name, uint64_t fromNs, uint64_t toNs, Histogram *h); // Counted between the two
+
+  private:
+    friend class Recorder; // Finds where to append
+    char mData[8 + 8 + 8 + 4 + 4];
+    // Note that the constructor has an assert to ensure this is correct size
+};
+
+}} // namespace Audinate::chrono
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
@@ -53,6 +53,11 @@
 
 #ifdef __linux__
 #include <time.h>
+#if defined(__x86_64__) && !defined(CHRONO_NO_TSC)
+#define CHRONO_TSC
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
 #endif
 #ifdef ARDUINO
 #include <esp32-hal.h>
@@ -64,6 +69,7 @@
 
 #include "chrono.h"
 #include <assert.h>
+#include <atomic>
 #include <cwchar>
 #include <math.h>
 #include <stdint.h>
@@ -74,7 +80,7 @@ namespace Audinate { namespace chrono {
 
 typedef int64_t ChronoTime;         // Time is 64 bit nanoseconds - which is about 300 years
 
-chrono_clock Chrono::clock = MONO;
+chrono_clock ChronoBase::clock = MONO;
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // PLATFORM DEPENDENT TIMER
@@ -83,14 +89,130 @@ chrono_clock Chrono::clock = MONO;
 // static const and a function to compare that with at run time in debug mode as a check.
 // The time must have an integral number of ns per tick - so NS_PER_SECOND/chronoFreq must be an integer.
 //
+#ifdef CHRONO_TSC
+//
+// The invariant TSC is read directly and converted to ns on the CLOCK_MONOTONIC_RAW time base, so the two can
+// be mixed freely.  The conversion is ns = ns0 + ((tsc - tsc0) * mult) >> 32, computed once with a short
+// busy wait and then refined each second against the first calibration point, giving an ever longer baseline
+// for the rate.  The re-anchor never steps time backwards, and slews in over the next second if ahead.  Parameters are double buffered with the
+// recalibration done by whichever reader finds it due, and skipped if another reader is already on it.  That is
+// a spike of about ten clock reads on one read a second, which ChronoBase::calibrate from a control thread avoids
+// by always being first (see chrono.h).
+//
+struct chrono_tsc_t
+{
+    uint64_t   tsc0;  // Counter at the anchor
+    ChronoTime ns0;   // Time at the anchor
+    uint64_t   mult;  // ns per tick in Q32
+    uint64_t   recal; // Counter at which the next recalibration is due
+};
+
+static chrono_tsc_t        chronoTsc[2];
+static volatile int        chronoTscIdx;  // The live set of parameters
+static volatile int        chronoTscBusy; // Recalibration underway
+static uint64_t            chronoTscBase; // The first calibration point - baseline for the rate
+static ChronoTime          chronoTscBaseNs;
+
+inline ChronoTime chronoGetMono(void)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    return (ChronoTime)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+inline uint64_t chronoGetTsc(void) { return __rdtsc(); } // Not serializing, which is fine at event granularity and cheaper than rdtscp
+
+static void chronoTscPair(uint64_t *tsc, ChronoTime *ns) // Tightest bracket of the counter around a clock read
+{
+    uint64_t best = ~(uint64_t)0;
+    *tsc          = 0; // The first pass always takes the outputs, but the compiler cannot see that
+    *ns           = 0;
+    for (int n = 0; n < 5; n++) {
+        uint64_t   t0 = chronoGetTsc();
+        ChronoTime t  = chronoGetMono();
+        uint64_t   t1 = chronoGetTsc();
+        if (t1 - t0 < best) {
+            best = t1 - t0;
+            *tsc = t0 + (t1 - t0) / 2;
+            *ns  = t;
+        }
+    }
+}
+
+inline ChronoTime chronoTscApply(const chrono_tsc_t *c, uint64_t tsc)
+{
+    return c->ns0 + (ChronoTime)(((__int128)(int64_t)(tsc - c->tsc0) * c->mult) >> 32); // Signed as another reader may re-anchor past us
+}
+
+static bool chronoTscInvariant(void)
+{
+    unsigned int a, b, c, d;
+    if (!__get_cpuid(0x80000000, &a, &b, &c, &d) || a < 0x80000007)
+        return false;
+    __get_cpuid(0x80000007, &a, &b, &c, &d);
+    return (d & (1 << 8)) != 0; // Invariant TSC - constant rate through P, C and T states
+}
+
+static bool chronoTscCalibrate(void)
+{
+    if (__sync_lock_test_and_set(&chronoTscBusy, 1))
+        return false;
+    uint64_t   tsc  = 0;
+    ChronoTime ns   = 0;
+    int        next = chronoTscIdx ^ 1;
+    if (chronoTscBase == 0) { // First calibration with a short busy wait
+        chronoTscPair(&chronoTscBase, &chronoTscBaseNs);
+        while (chronoGetMono() - chronoTscBaseNs < 10000000)
+            ;
+    }
+    chronoTscPair(&tsc, &ns);
+    chrono_tsc_t *c    = &chronoTsc[next];
+    uint64_t      mult = (uint64_t)(((unsigned __int128)(ns - chronoTscBaseNs) << 32) / (tsc - chronoTscBase));
+    uint64_t      span = (1000000000ULL << 32) / mult; // Ticks in one second
+    c->tsc0            = tsc;
+    c->ns0             = ns;
+    if (chronoTsc[chronoTscIdx].mult != 0 && chronoTscApply(&chronoTsc[chronoTscIdx], tsc) > ns)
+        c->ns0 = chronoTscApply(&chronoTsc[chronoTscIdx], tsc);                   // Never step backwards, instead
+    c->mult  = (uint64_t)(((unsigned __int128)(ns + 1000000000 - c->ns0) << 32) / span); // slew back over the second
+    c->recal = tsc + span;
+    __sync_synchronize();
+    chronoTscIdx = next;
+    __sync_lock_release(&chronoTscBusy);
+    return true;
+}
+
+inline ChronoTime chronoTscNs(void)
+{
+    const chrono_tsc_t *c   = &chronoTsc[chronoTscIdx];
+    uint64_t            tsc = chronoGetTsc();
+    if (tsc >= c->recal && chronoTscCalibrate()) {
+        c   = &chronoTsc[chronoTscIdx];
+        tsc = chronoGetTsc();
+    }
+    return chronoTscApply(c, tsc);
+}
+#endif
+
 #if defined(__linux__) || defined(__APPLE__)
-inline ChronoTime chronoGetCounter(void)
+inline ChronoTime chronoReadClock(chrono_clock c)
 {
+#ifdef CHRONO_TSC
+    if (c == TSC)
+        return chronoTscNs();
+#endif
     timespec now;
-    clock_gettime(Chrono::getClock(), &now);
+    clock_gettime(c, &now);
     return (ChronoTime)now.tv_sec * 1000000000 + now.tv_nsec;
 };
 
+inline ChronoTime chronoGetCounter(void) { return chronoReadClock(ChronoBase::getClock()); }
+
+static uint64_t chronoSourceMono(void *) { return chronoReadClock(MONO); } // The built in sources for Chrono::source
+static uint64_t chronoSourceRealtime(void *) { return chronoReadClock(REALTIME); }
+static uint64_t chronoSourceTai(void *) { return chronoReadClock(TAI); }
+#ifdef CHRONO_TSC
+static uint64_t chronoSourceTsc(void *) { return chronoTscNs(); }
+#endif
 #endif
 #ifdef ARDUINO
 static hw_timer_t *chronoTimer;
@@ -110,6 +232,52 @@ inline ChronoTime chronoGetCounter(void)
 };
 #endif
 
+void ChronoBase::setClock(chrono_clock c)
+{
+    if (c == TSC) {
+#ifdef CHRONO_TSC
+        if (chronoTscInvariant() && (chronoTsc[chronoTscIdx].mult != 0 || chronoTscCalibrate()))
+            clock = TSC;
+        else
+#endif
+            clock = MONO;
+        return;
+    }
+    clock = c;
+}
+
+ChronoSource ChronoBase::source(chrono_clock c)
+{
+#if defined(__linux__) || defined(__APPLE__)
+    switch (c) {
+    case TSC:
+#ifdef CHRONO_TSC
+        if (chronoTscInvariant() && (chronoTsc[chronoTscIdx].mult != 0 || chronoTscCalibrate()))
+            return chronoSourceTsc;
+#endif
+        return chronoSourceMono;
+    case REALTIME:
+        return chronoSourceRealtime;
+    case TAI:
+        return chronoSourceTai;
+    default:
+        return chronoSourceMono;
+    }
+#else
+    (void)c;
+    return nullptr; // Only the process clock on these targets
+#endif
+}
+
+bool ChronoBase::calibrate()
+{
+#ifdef CHRONO_TSC
+    if (chronoTsc[chronoTscIdx].mult != 0)    // In use, as the process clock or through source(TSC)
+        return chronoTscCalibrate();
+#endif
+    return false;
+}
+
 inline timespec chronoNativeTimespec(ChronoTime t)
 {
     timespec ret;
@@ -137,27 +305,53 @@ static const int32_t chronoNativeLog2Table[] = { // 256 entries 0x00 -> 0x80 or
     0x00f44636, 0x00f504a4, 0x00f5c2b0, 0x00f6805a, 0x00f73da4, 0x00f7fa8c, 0x00f8b714, 0x00f9733c, 0x00fa2f04, 0x00faea6d, 0x00fba578, 0x00fc6023, 0x00fd1a71, 0x00fdd460, 0x00fe8df2, 0x00ff4728,
     0x01000000};
 
+inline int chronoNativeMsb(uint64_t x) // Index of the top set bit - x must be non zero
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#elif defined(_WIN64)
+    unsigned long n;
+    _BitScanReverse64(&n, x);
+    return (int)n;
+#else
+    int n = 0;
+    while (x >>= 1)
+        n++;
+    return n;
+#endif
+}
+
+inline uint64_t chronoNativeMulHi(uint64_t m, uint64_t x) // High 64 bits of m * x for x < 2^32 and m < 2^63
+{
+    return ((m >> 32) * x + (((m & 0xFFFFFFFF) * x) >> 32)) >> 32;
+}
+
 typedef uint32_t        chronoNative8f24;
 inline chronoNative8f24 chronoNativeLog2(uint64_t x) // Create a 8.24 float which is log2 of the input
 {
-    int y = 9; // We have 8 bits (257) table entries, and one extra for rounding - so need to shift 0x001 to 0x200 by 9
     if (x == 0)
         return 0; // Avoid this error case (optimize out as an assert if needed)
-    while (x >= 0x00000400) {
-        x = x >> 1;
-        y++;
-    }; // Scale it to be from 512 - 1024
-    while (x < 0x00000200) {
-        x = x << 1;
-        y--;
-    };                                                                    // Counting bits - can be done with roll & mask
+    int y = chronoNativeMsb(x); // We have 8 bits (257) table entries, and one extra for rounding - so scale to 0x200 - 0x3FF
+    if (y > 9)
+        x >>= y - 9;
+    else
+        x <<= 9 - y;
     return (y << 24) + chronoNativeLog2Table[((x & 0x000001FF) + 1) / 2]; // Reduction of bias from the +1/2
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // CHRONOMETER SPECIFIC CORE STRUCTURE - Abstracted and mostly platform independent
 //
-// General implementation may be optimized if needed, for example for fixed width or power of 2 bins.
+// LOGLIN is the log-linear scheme of HDR histograms.  Values in units of the width (a power of 2 set by the
+// lowest value) are binned exactly below 2^subBits, and each octave above that is split into 2^(subBits-1)
+// equal bins, so the relative resolution is held to the significant digits across the whole range.  The bin
+// index is a clz and two shifts.  These generally need more than the 101 bins held inline, so the bins can live
+// in caller storage, kept as a byte offset from the chrono so that both can sit together in shared memory.
+//
+// The bin is found without a divide.  A power of 2 width is a shift, and otherwise the config precomputes a
+// reciprocal so that offsets up to 2^32 are a multiply high, which is exact in that range (Lemire, Kaser and
+// Kurz, "Faster remainder by direct computation").  Anything further out falls back to the divide.  The same
+// lookup is public as ChronoBase::bin, so ats_bench can sweep it against the divide.
 //
 // A note on concurrency.  Reset and Configure are not strictly thread safe.  However, we use stale
 // pointer cycling and deliberate ordering of things to ensure the worker threads are crash safe.
@@ -165,9 +359,14 @@ inline chronoNative8f24 chronoNativeLog2(uint64_t x) // Create a 8.24 float whic
 // If needed, the events value can be used as a constancy test for bracketing.  The bin values are
 // only ever incremented other than in a reset, and so the bin set is naturally consistent.
 //
+// For a fully consistent copy, snapshot brackets it with two sequence counters in the style of a seqlock.
+// seq is bumped to odd and back to even around every update by the single real time writer, and cseq in the
+// same way around a reset or config from the control side.  They are separate so neither writer ever waits on
+// or corrupts the other's count.  The reader retries on an odd or changed count and never blocks the writer.
+//
 
-struct chrono_t // Struct for machine specific timing stamp
-// 64 + 4 + 4 + 8 + 8 + 8 + 8 + 8 + 4 + 4 + 101*4 + 4
+template <typename B, int Bins> struct chrono_t // Struct for machine specific timing stamp
+// 64 + 4 + 4 + 8 + 8 + 8 + 8 + 8 + 4 + 4 + 8 + 4 + 4 + 8 + 8 + 8 + 8 + 8 + 8 + 4 + 4 + 4 + 4 + Bins*sizeof(B) + 4 + 4 + 4
 {
     char       name[64];  // Name of the counter
     HistFlag   flags;     // Options about how this setup - Log, Dither, Counter
@@ -179,45 +378,133 @@ struct chrono_t // Struct for machine specific timing stamp
     ChronoTime start;     // The left edge of the first bin - if width = 1 it is also the centre
     uint32_t   width;     // The width of each bin (no sense being fractional and must be >= 1)
     int32_t    bins;      // The number of bins also allocated size of data
-    uint32_t   bin[101];  // Variable sized structure to hold the bins - note sum(bins) = count-1
+    uint64_t   recip;     // Ceiling of 2^64 / width for the multiply high binning
+    int32_t    shift;     // Log2 of the width if a power of 2, otherwise -1 to use the reciprocal
+    int32_t    subBits;   // LOGLIN only - log2 of the bins in the linear range, with half that per octave above
+    int64_t    binOffset; // Byte offset from this struct to external bins, or 0 to use the bins here
+    ChronoSource source;  // Clock for this chrono, or nullptr for the process clock
+    void *     context;   // Passed to the source
+    int64_t    windowOffset; // Byte offset from this struct to the window bins, windows x bins, or 0 if not windowed
+    ChronoTime windowNs;  // Length of each window
+    ChronoTime windowEnd; // Time the current window closes
+    int32_t    windows;   // Windows in the ring, or 0 if not windowed
+    int32_t    window;    // The window being filled
+    int32_t    windowsFull; // Complete windows held, at most windows - 1 as the current one is partial
+    int32_t    windowPad; // Keeps the bins 8 byte aligned
+    B          bin[Bins]; // Variable sized structure to hold the bins - note sum(bins) = count-1
     uint32_t   rand;      // A random number generator of some form (may be simple cycle)
+    uint32_t   seq;       // Odd while the writer is updating - bumped only by event, add, count and restart
+    uint32_t   cseq;      // Odd while a reset or config is underway
 };
 
-Chrono::Chrono()
+inline void chronoSeqBegin(volatile uint32_t *seq) // Odd while updating - the fence keeps the updates after it
 {
-    assert(sizeof(mData) >= sizeof(chrono_t));               // Ensure hidden data allocation is sufficient
+    *seq = *seq + 1;
+    std::atomic_thread_fence(std::memory_order_release);
+}
 
-    chrono_t *p = (chrono_t *)mData;
-    memset(p, 0, sizeof(chrono_t)); // Most initialize to zero
+inline void chronoSeqEnd(volatile uint32_t *seq) // Back to even once the updates are all visible
+{
+    std::atomic_thread_fence(std::memory_order_release);
+    *seq = *seq + 1;
+}
+
+template <typename B, int Bins> inline ChronoTime chronoNow(const chrono_t<B, Bins> *p) { return p->source ? p->source(p->context) : chronoGetCounter(); }
+
+template <typename B, int Bins> inline uint32_t chronoRand(chrono_t<B, Bins> *p) { return p->rand = p->rand * 0x0019660d + 0x3c6ef35f; } // Classic rand PRNG
+
+template <typename B, int Bins> inline B *chronoBins(chrono_t<B, Bins> *p) { return p->binOffset ? (B *)((char *)p + p->binOffset) : p->bin; }
+
+inline void chronoBinWidth(uint32_t width, int32_t *shift, uint64_t *recip) // A shift for a power of 2 width, else the reciprocal
+{
+    *shift = (width & (width - 1)) ? -1 : chronoNativeMsb(width);
+    *recip = *shift < 0 ? ~(uint64_t)0 / width + 1 : 0;
+}
+
+inline int chronoBinOf(ChronoTime d, uint32_t width, int32_t shift, uint64_t recip, int bins) // Bin of an offset from the first bin, clamped at the ends
+{
+    uint64_t bin;
+    if (d <= 0)
+        return 0;
+    if (shift >= 0)
+        bin = (uint64_t)d >> shift;
+    else if (d < ((ChronoTime)1 << 32))
+        bin = chronoNativeMulHi(recip, (uint64_t)d);
+    else
+        bin = (uint64_t)d / width;
+    return bin >= (uint64_t)bins ? bins - 1 : (int)bin;
+}
+
+template <typename B, int Bins> inline B *chronoWindow(chrono_t<B, Bins> *p, int w) { return (B *)((char *)p + p->windowOffset) + w * p->bins; }
+
+template <typename B, int Bins> inline int chronoLogLinIndex(const chrono_t<B, Bins> *p, uint64_t v) // The HDR bin of a value - linear below 2^subBits
+{
+    v >>= p->shift;
+    int e   = chronoNativeMsb(v | ((1 << p->subBits) - 1)) - p->subBits + 1; // Octave above the linear range, or 0 in it
+    int bin = (e << (p->subBits - 1)) + (int)(v >> e);
+    return bin >= p->bins ? p->bins - 1 : bin;
+}
+
+template <typename B, int Bins> inline uint64_t chronoLogLinEdge(const chrono_t<B, Bins> *p, int bin) // Left edge of a LOGLIN bin
+{
+    int e = (bin >> (p->subBits - 1)) - 1;
+    if (e <= 0)
+        return (uint64_t)bin << p->shift;
+    return (uint64_t)(bin - (e << (p->subBits - 1))) << (e + p->shift);
+}
+
+inline int chronoLogLinSubBits(int digits) // Enough bins per octave to resolve the significant digits
+{
+    uint32_t n = 2;
+    for (int d = 0; d < digits; d++)
+        n *= 10;
+    return chronoNativeMsb(n - 1) + 1;
+}
+
+template <typename B, int Bins> ChronoOf<B, Bins>::ChronoOf()
+{
+    assert(sizeof(mData) >= sizeof(chrono_t<B, Bins>));               // Ensure hidden data allocation is sufficient
+
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    memset(p, 0, sizeof(chrono_t<B, Bins>)); // Most initialize to zero
     p->width = 1;                   // code past config count = 0 creating a div0 exception
     strncpy(p->name, "CHRONO NOT CONFIGURED", sizeof(p->name) - 1);
     p->lastDiff = 0;
     p->lastTime = chronoGetCounter();
 }
 
-Chrono::~Chrono() {}
+template <typename B, int Bins> ChronoOf<B, Bins>::~ChronoOf() {}
+
+template <typename B, int Bins> void chronoClear(chrono_t<B, Bins> *p) // Clear the data without touching the config or the writer sequence
+{
+    ChronoTime now = chronoNow(p);
+    p->configs++;                                              // Only do this once - it also signals imminent data corruption
+    do {                                                       // Loop to rinse and repeat if needed
+        memset(chronoBins(p), 0, p->bins * sizeof(B));        // Clear the data
+        if (p->windows)                                        // And every window, starting again from the first
+            memset(chronoWindow(p, 0), 0, p->windows * p->bins * sizeof(B));
+        p->window      = 0;
+        p->windowsFull = 0;
+        p->windowEnd   = now + p->windowNs;
+        p->events    = 0;                                      // Reset event count
+        p->startTime = now;                                    // Set the time we reset, will be updated once events==1
+        p->lastTime  = now;                                    // Valid once events==1, not used until events==2
+        p->lastDiff  = 0;                                      // Valid only if events>=2
+        p->rand      = p->width / 2;                           // Reset the seed and centre it - be predictable in testing
+    } while (p->events != 0);                                  // This not being zero indicates we were interrupted by an update
+}
 
-void Chrono::reset() // Reset without changing the config - use sparingly as each client must recalibrate
+template <typename B, int Bins> void ChronoOf<B, Bins>::reset() // Reset without changing the config - use sparingly as each client must recalibrate
 {
-    chrono_t * p   = (chrono_t *)mData;
-    ChronoTime now = chronoGetCounter();
-    p->configs++;                                 // Only do this once - it also signals imminent data corruption
-    chrono_t chrono;                              // Temporary chrono block to bit blit
-    memcpy(&chrono, p, sizeof(chrono_t));         // Copy what was there
-    memset(chrono.bin, 0, p->bins * sizeof(int)); // Clear the data
-    chrono.events    = 0;                         // Reset event count
-    chrono.startTime = now;                       // Set the time we reset, will be updated once events==1
-    chrono.lastTime  = now;                       // Valid once events==1, not used until events==2
-    chrono.lastDiff  = 0;                         // Valid only if events>=2
-    chrono.rand      = p->width / 2;              // Reset the seed and centre it - be predictable in testing
-    do {                                          // Loop to rinse and repeat if needed
-        memcpy(p, &chrono, sizeof(chrono_t));     // Bit blit the new config
-    } while (p->events != 0);                     // This not being zero indicates we were interrupted by an update
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    chronoSeqBegin(&p->cseq);
+    chronoClear(p);
+    chronoSeqEnd(&p->cseq);
 }
 
-bool Chrono::config(float bin0, float binN, int bins, HistFlag flags, const char *name)
+template <typename B, int Bins> bool ChronoOf<B, Bins>::config(float bin0, float binN, int bins, HistFlag flags, const char *name)
 {
-    chrono_t *p = (chrono_t *)mData;
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
     assert(bins > 1);
     assert(binN > bin0);
 
@@ -228,9 +515,10 @@ bool Chrono::config(float bin0, float binN, int bins, HistFlag flags, const char
     if (p->configs > 0 && name == nullptr)
         name = p->name;
 
-    if (bins > (sizeof(p->bin) / sizeof(uint32_t)))
-        bins = (sizeof(p->bin) / sizeof(uint32_t));
+    if (bins > Bins)
+        bins = Bins;
 
+    chronoSeqBegin(&p->cseq);
     ChronoTime freq = 1000000000;
     if (flags & HistFlag::COUNTER) freq = 1; // Hijack for counter
 
@@ -247,12 +535,70 @@ bool Chrono::config(float bin0, float binN, int bins, HistFlag flags, const char
     }
     if (p->width <= 0)
         p->width = 1; // Has to be at least one - counter resolution limit
-    p->events = 0;    // This can signal a reconfigure underway or chrono premature
-    p->bins   = bins;
-    p->flags  = flags;
+    chronoBinWidth(p->width, &p->shift, &p->recip);
+    p->events    = 0; // This can signal a reconfigure underway or chrono premature
+    p->bins      = bins;
+    p->flags     = (HistFlag)(flags & ~HistFlag::LOGLIN);
+    p->subBits   = 0;
+    p->binOffset = 0;
+    p->windows   = 0; // The bins have changed under any windows
     if (name != nullptr)
         strncpy(p->name, name, sizeof(p->name) - 1);
-    reset();
+    chronoClear(p);
+    chronoSeqEnd(&p->cseq);
+    return true;
+}
+
+template <typename B, int Bins> int ChronoOf<B, Bins>::logLinBins(float lowest, float highest, int digits, HistFlag flags)
+{
+    chrono_t<B, Bins> c;
+    ChronoTime freq = (flags & HistFlag::COUNTER) ? 1 : 1000000000;
+    if (digits < 1)
+        digits = 1;
+    if (digits > 3)
+        digits = 3;
+    c.subBits = chronoLogLinSubBits(digits);
+    c.shift   = lowest * freq >= 2 ? chronoNativeMsb((uint64_t)(lowest * freq)) : 0;
+    c.bins    = 0x7FFFFFFF;
+    return chronoLogLinIndex(&c, (uint64_t)(highest * freq)) + 1;
+}
+
+template <typename B, int Bins> bool ChronoOf<B, Bins>::configLogLin(float lowest, float highest, int digits, HistFlag flags, const char *name, B *storage, int storageBins)
+{
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    assert(highest > lowest);
+
+    if (p->configs > 0 && (p->flags & COUNTER))
+        flags = (HistFlag)(flags | COUNTER);
+    if (p->configs == 0 && name == nullptr)
+        p->name[0] = 0;
+    if (p->configs > 0 && name == nullptr)
+        name = p->name;
+
+    int bins = logLinBins(lowest, highest, digits, flags);
+    if (storage == nullptr || storageBins <= 0) {
+        storage     = p->bin;
+        storageBins = Bins;
+    }
+    if (bins > storageBins)
+        bins = storageBins; // Saturates into the last bin as for the other modes
+
+    ChronoTime freq = (flags & HistFlag::COUNTER) ? 1 : 1000000000;
+    chronoSeqBegin(&p->cseq);
+    p->events    = 0; // This can signal a reconfigure underway or chrono premature
+    p->subBits   = chronoLogLinSubBits(digits < 1 ? 1 : digits > 3 ? 3 : digits);
+    p->shift     = lowest * freq >= 2 ? chronoNativeMsb((uint64_t)(lowest * freq)) : 0;
+    p->width     = 1 << p->shift;
+    p->start     = 0;
+    p->recip     = 0;
+    p->bins      = bins;
+    p->binOffset = storage == p->bin ? 0 : (char *)storage - (char *)p;
+    p->windows   = 0;
+    p->flags     = (HistFlag)((flags | HistFlag::LOGLIN) & ~(HistFlag::LOGX | HistFlag::DITHER));
+    if (name != nullptr)
+        strncpy(p->name, name, sizeof(p->name) - 1);
+    chronoClear(p);
+    chronoSeqEnd(&p->cseq);
     return true;
 }
 
@@ -265,53 +611,126 @@ bool Chrono::config(float bin0, float binN, int bins, HistFlag flags, const char
 // a block.  The representation and all aspects of this remain the same, the update simply uses a divide
 // through of the elapsed time by the number of events.
 //
+// A weight stands the one interval in for that many, for callers that only record every Nth event.  They
+// should restart on the event before so the interval is still a single period.  The first event is never
+// weighted so the period estimate holds.
+//
+// Values are logged with count, which also stamps the time of the value, or add which does not touch the
+// time at all.  All of the time based calls take an optional time so that one clock read can be shared.
+//
+
+template <typename B, int Bins> inline int chronoBin(const chrono_t<B, Bins> *p, ChronoTime t) // Map a dithered time or value to a bin, clamped at the ends
+{
+    return chronoBinOf(t - p->start, p->width, p->shift, p->recip, p->bins);
+}
+
+int ChronoBase::bin(int64_t offset, uint32_t width, int bins)
+{
+    int32_t  shift;
+    uint64_t recip;
+    chronoBinWidth(width < 1 ? 1 : width, &shift, &recip);
+    return chronoBinOf(offset, width < 1 ? 1 : width, shift, recip, bins);
+}
+
+inline uint32_t chronoDither(uint32_t r, uint32_t n) { return (uint32_t)(((uint64_t)r * n) >> 32); } // Uniform 0..n-1 from the high bits
+
+template <typename B, int Bins> inline void chronoBump(chrono_t<B, Bins> *p, int bin, uint32_t n) // Count into the lifetime bins and the current window
+{
+    chronoBins(p)[bin] += n;
+    if (p->windows)
+        chronoWindow(p, p->window)[bin] += n;
+}
+
+template <typename B, int Bins> void chronoRotate(chrono_t<B, Bins> *p, ChronoTime now) // Move on to the window holding now, clearing those passed over
+{
+    for (int n = 0; now >= p->windowEnd && n < p->windows; n++) {
+        p->window = p->window + 1 < p->windows ? p->window + 1 : 0;
+        memset(chronoWindow(p, p->window), 0, p->bins * sizeof(B));
+        p->windowEnd += p->windowNs;
+        if (p->windowsFull < p->windows - 1)
+            p->windowsFull++;
+    }
+    if (now >= p->windowEnd) // A gap longer than the ring - all clear so just line up on now
+        p->windowEnd = now + p->windowNs;
+}
+
+template <typename B, int Bins> inline void chronoAdd(chrono_t<B, Bins> *p, int val, int count)
+{
+    if (p->flags & HistFlag::LOGLIN)
+        chronoBump(p, chronoLogLinIndex(p, val < 0 ? 0 : val), count);
+    else {
+        if (p->flags & HistFlag::LOGX)
+            val = chronoNativeLog2(val);
+        chronoBump(p, chronoBin(p, (ChronoTime)val + chronoDither(chronoRand(p), p->width)), count); // Dither the bin
+    }
+    p->events += count;
+}
 
-void Chrono::restart() { ((chrono_t *)mData)->lastTime = chronoGetCounter(); }
+template <typename B, int Bins> void ChronoOf<B, Bins>::restart(uint64_t now)
+{
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    chronoSeqBegin(&p->seq);
+    p->lastTime = now ? now : chronoNow(p);
+    chronoSeqEnd(&p->seq);
+}
 
-void Chrono::event(uint64_t now, int count)
+template <typename B, int Bins> void ChronoOf<B, Bins>::event(uint64_t now, int count, int weight)
 {
-    if (now == 0) now = chronoGetCounter();
-    chrono_t *p = (chrono_t *)mData;
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    if (now == 0) now = chronoNow(p);
+    chronoSeqBegin(&p->seq);
+    if (p->windows && (ChronoTime)now >= p->windowEnd)
+        chronoRotate(p, now);
     if (p->events > 0) // First call is an edge case.  Number of logs of interval (sum(bins))
     {                  // equal to one les than the number of times update is called (count-1)
         p->lastDiff  = now - p->lastTime;
         ChronoTime t = p->lastDiff;
         if (count > 1) {
-            t += (rand() % count);             // Dither this as we need to integer divide next
+            t += chronoDither(chronoRand(p), count); // Dither this as we need to integer divide next
             t /= count;                        // This is an integer divide
         }
-        if (p->flags & HistFlag::LOGX)
-            t = chronoNativeLog2(t);
-        t += rand() % p->width;                     // Dither for stochastic resonance - may optimize to nothing if rand next is always 0
-        int bin = (int)((t - p->start) / p->width); // Could be done as a magic# mult
-        if (bin >= p->bins)
-            bin = p->bins - 1; // Could be a mask if optimzation needed
-        if (bin < 0)
-            bin = 0;
-        p->bin[bin] += count;
-    } else
+        if (p->flags & HistFlag::LOGLIN)
+            chronoBump(p, chronoLogLinIndex(p, t < 0 ? 0 : t), count * weight);
+        else {
+            if (p->flags & HistFlag::LOGX)
+                t = chronoNativeLog2(t);
+            t += chronoDither(chronoRand(p), p->width); // Dither for stochastic resonance
+            chronoBump(p, chronoBin(p, t), count * weight);
+        }
+        p->events   += weight;
+    } else {
         p->startTime = now;
+        p->events++;
+    }
     p->lastTime = now;
-    p->events++;
+    chronoSeqEnd(&p->seq);
+}
+
+template <typename B, int Bins> void ChronoOf<B, Bins>::add(int val, int count)
+{
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    chronoSeqBegin(&p->seq);
+    if (p->windows) { // Only windows need the time
+        ChronoTime now = chronoNow(p);
+        if (now >= p->windowEnd)
+            chronoRotate(p, now);
+    }
+    chronoAdd(p, val, count);
+    chronoSeqEnd(&p->seq);
 }
 
-void Chrono::count(int val, int count)
+template <typename B, int Bins> void ChronoOf<B, Bins>::count(int val, int count, uint64_t now)
 {
-    ChronoTime now = chronoGetCounter();
-    chrono_t * p   = (chrono_t *)mData;
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    if (now == 0) now = chronoNow(p);
+    chronoSeqBegin(&p->seq);
+    if (p->windows && (ChronoTime)now >= p->windowEnd)
+        chronoRotate(p, now);
     if (p->events == 0)
         p->startTime = now;
-    if (p->flags & HistFlag::LOGX)
-        val = chronoNativeLog2(val);
-    val += (rand() % p->width);                   // Dither the bin
-    int bin = (int)((val - p->start) / p->width); // Could be done as a magic# mult
-    if (bin >= p->bins)
-        bin = p->bins - 1;
-    if (bin < 0)
-        bin = 0;
-    p->bin[bin] += count;
+    chronoAdd(p, val, count);
     p->lastTime = now;
-    p->events += count;
+    chronoSeqEnd(&p->seq);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -319,23 +738,96 @@ void Chrono::count(int val, int count)
 //
 //
 
-int32_t  Chrono::configCount() { return ((chrono_t *)mData)->configs; }
-int64_t  Chrono::eventCount() { return ((chrono_t *)mData)->events; }
-timespec Chrono::now() { return chronoNativeTimespec(chronoGetCounter()); }
-uint64_t Chrono::nowNs() { return chronoGetCounter(); }
-timespec Chrono::startTime() { return chronoNativeTimespec(((chrono_t *)mData)->startTime); }
-timespec Chrono::lastTime() { return chronoNativeTimespec(((chrono_t *)mData)->lastTime); }
-int64_t  Chrono::diffNs() { return  ((chrono_t *)mData)->lastDiff; }
-int64_t  Chrono::sinceNs() { return chronoGetCounter() - ((chrono_t *)mData)->lastTime; }
-int64_t  Chrono::periodNs()
+template <typename B, int Bins> int32_t  ChronoOf<B, Bins>::configCount() { return ((chrono_t<B, Bins> *)mData)->configs; }
+template <typename B, int Bins> int64_t  ChronoOf<B, Bins>::eventCount() { return ((chrono_t<B, Bins> *)mData)->events; }
+timespec ChronoBase::now() { return chronoNativeTimespec(chronoGetCounter()); }
+uint64_t ChronoBase::nowNs() { return chronoGetCounter(); }
+template <typename B, int Bins> timespec ChronoOf<B, Bins>::startTime() { return chronoNativeTimespec(((chrono_t<B, Bins> *)mData)->startTime); }
+template <typename B, int Bins> timespec ChronoOf<B, Bins>::lastTime() { return chronoNativeTimespec(((chrono_t<B, Bins> *)mData)->lastTime); }
+template <typename B, int Bins> int64_t  ChronoOf<B, Bins>::diffNs() { return  ((chrono_t<B, Bins> *)mData)->lastDiff; }
+template <typename B, int Bins> int64_t  ChronoOf<B, Bins>::sinceNs(uint64_t now) { return (now ? now : chronoNow((chrono_t<B, Bins> *)mData)) - ((chrono_t<B, Bins> *)mData)->lastTime; }
+template <typename B, int Bins> uint64_t ChronoOf<B, Bins>::sourceNs() { return chronoNow((chrono_t<B, Bins> *)mData); }
+
+template <typename B, int Bins> void ChronoOf<B, Bins>::setSource(ChronoSource source, void *context) // Restarts the interval on the new clock - reset if the time base changes
 {
-    chrono_t *p = (chrono_t *)mData;
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    chronoSeqBegin(&p->seq);
+    p->context  = context;
+    p->source   = source;
+    p->lastTime = chronoNow(p);
+    chronoSeqEnd(&p->seq);
+}
+template <typename B, int Bins> int64_t  ChronoOf<B, Bins>::periodNs()
+{
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
     if (p->events <= 1)
         return 0;
     return (p->lastTime - p->startTime) / (p->events - 1);
 }
 
-inline uint32_t Chrono::rand() { ((chrono_t *)mData)->rand =  ((chrono_t *)mData)->rand * 0x0019660d + 0x3c6ef35f; return ((chrono_t *)mData)->rand; } // Classic rand PRNG
+template <typename B, int Bins> int32_t ChronoOf<B, Bins>::windowCount() { return ((chrono_t<B, Bins> *)mData)->windowsFull; }
+
+template <typename B, int Bins> bool ChronoOf<B, Bins>::configWindows(int windows, float period, B *storage, int storageBins)
+{
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    if (windows != 0 && (windows < 2 || period <= 0 || p->bins > CHRONO_WINDOW_BINS || storage == nullptr || storageBins < windows * p->bins))
+        return false;
+    chronoSeqBegin(&p->cseq);
+    p->windows      = windows;
+    p->windowNs     = (ChronoTime)((double)period * 1e9);
+    p->windowOffset = windows ? (char *)storage - (char *)p : 0;
+    chronoClear(p); // Windows only make sense from a common start
+    chronoSeqEnd(&p->cseq);
+    return true;
+}
+
+template <typename B, int Bins> inline uint32_t ChronoOf<B, Bins>::rand() { return chronoRand((chrono_t<B, Bins> *)mData); }
+
+// Copy the whole chrono between two even and unchanged reads of both sequence counters.  Bins held outside
+// the chrono go to the storage given, and the copy refers to them there.  Windows follow them in the storage
+// if there is room, otherwise the copy is the lifetime only.  Returns the storage bins used, or -1
+// if there was not enough storage or no clean copy within the tries.
+template <typename B, int Bins> int ChronoOf<B, Bins>::snapshot(ChronoOf *copy, B *storage, int storageBins, int tries)
+{
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    chrono_t<B, Bins> *c = (chrono_t<B, Bins> *)copy->mData;
+    assert(copy != this);
+    for (; tries > 0; tries--) {
+        uint32_t seq  = *(volatile uint32_t *)&p->seq;
+        uint32_t cseq = *(volatile uint32_t *)&p->cseq;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((seq | cseq) & 1)
+            continue;
+        memcpy(c, p, sizeof(chrono_t<B, Bins>));
+        int used = 0;
+        if (c->binOffset) {
+            if (storage == nullptr || c->bins > storageBins || c->bins < 0)
+                used = -1;
+            else {
+                memcpy(storage, (char *)p + c->binOffset, c->bins * sizeof(B));
+                used = c->bins;
+            }
+        }
+        int windows = 0;
+        if (c->windows && used >= 0 && storage != nullptr && used + c->windows * c->bins <= storageBins) {
+            windows = c->windows * c->bins;
+            memcpy(storage + used, (char *)p + c->windowOffset, windows * sizeof(B));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (*(volatile uint32_t *)&p->seq != seq || *(volatile uint32_t *)&p->cseq != cseq)
+            continue;
+        if (used < 0)
+            return -1;
+        c->binOffset    = used ? (char *)storage - (char *)c : 0;
+        c->windowOffset = windows ? (char *)(storage + used) - (char *)c : 0;
+        c->windows      = windows ? c->windows : 0; // Windows are dropped from the copy if there is no room for them
+        used           += windows;
+        c->seq       = 0;
+        c->cseq      = 0;
+        return used;
+    }
+    return -1;
+}
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -353,15 +845,39 @@ inline uint32_t Chrono::rand() { ((chrono_t *)mData)->rand =  ((chrono_t *)mData
 // are no more events in that time.
 //
 
-void Chrono::histogram(Histogram *h)
+// LOGLIN has more bins than a Histogram holds, so it is rebinned onto a LOGX histogram over the same range with
+// each bin placed at its centre.  The resolution this gives is about a 100th of the range in log terms.
+//
+template <typename B, int Bins> void chronoLogLinHistogram(chrono_t<B, Bins> *p, HistogramOf<B, Bins> *h, ChronoTime freq)
+{
+    B         rebin[Bins];
+    B *       bin = chronoBins(p);
+    int       n   = p->bins < Bins ? p->bins : Bins;
+    double    lo  = (double)p->width;                                                     // First bin with a full unit
+    double    hi  = (double)chronoLogLinEdge(p, p->bins);                                 // Right edge of the last bin
+    double    w   = log(hi / lo) / (n - 1);
+    memset(rebin, 0, sizeof(rebin));
+    for (int b = 0; b < p->bins; b++) {
+        if (bin[b] == 0)
+            continue;
+        double x = 0.5 * (double)(chronoLogLinEdge(p, b) + chronoLogLinEdge(p, b + 1)); // Centre of the bin
+        int    r = x <= lo ? 0 : (int)(log(x / lo) / w + 0.5);
+        rebin[r < n ? r : n - 1] += bin[b];
+    }
+    h->reconfig((float)(lo / freq), (float)(hi / freq), n, (HistFlag)((p->flags & ~HistFlag::LOGLIN) | HistFlag::LOGX | HistFlag::DITHER), rebin, p->name);
+}
+
+template <typename B, int Bins> void ChronoOf<B, Bins>::histogram(HistogramOf<B, Bins> *h)
 {
     assert(h != nullptr);
-    chrono_t * p    = (chrono_t *)mData;
+    chrono_t<B, Bins> * p    = (chrono_t<B, Bins> *)mData;
     ChronoTime freq = 1000000000;
     if (p->flags & HistFlag::COUNTER) freq = 1;
+    if (p->flags & HistFlag::LOGLIN) {
+        chronoLogLinHistogram(p, h, freq);
+        return;
+    }
 
-    unsigned int AnInt = 0xFFFFFFE;                       // Be sure to use full precision sub and timespec and avoid overflow
-    assert((unsigned int)*((HistType *)&AnInt) == AnInt); // Just to check hist_t is an int other wise we need to copy and cast bins
     float bin0, binN;
 
     if (p->flags & HistFlag::LOGX) {
@@ -372,9 +888,56 @@ void Chrono::histogram(Histogram *h)
         binN = bin0 + (float)(p->bins - 1) * p->width / freq;
     }
 
-    h->reconfig(bin0, binN, p->bins, p->flags | HistFlag::DITHER, p->bin, p->name);
+    h->reconfig(bin0, binN, p->bins, p->flags | HistFlag::DITHER, chronoBins(p), p->name);
 }
 
+// The windows are summed into a copy of the chrono, so the lifetime path above does the rest.  As for snapshot
+// the copy is retried if an update, rotation or reset lands during it.
+//
+template <typename B, int Bins> bool ChronoOf<B, Bins>::histogram(HistogramOf<B, Bins> *h, int windows, int tries)
+{
+    assert(h != nullptr);
+    chrono_t<B, Bins> *p = (chrono_t<B, Bins> *)mData;
+    ChronoOf  copy;
+    chrono_t<B, Bins> *c = (chrono_t<B, Bins> *)copy.mData;
+    B         sum[CHRONO_WINDOW_BINS];
+    for (; tries > 0; tries--) {
+        uint32_t seq  = *(volatile uint32_t *)&p->seq;
+        uint32_t cseq = *(volatile uint32_t *)&p->cseq;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((seq | cseq) & 1)
+            continue;
+        memcpy(c, p, sizeof(chrono_t<B, Bins>));
+        if (c->windows == 0 || c->bins > CHRONO_WINDOW_BINS)
+            return false;
+        int n = windows < c->windowsFull ? windows : c->windowsFull;
+        memset(sum, 0, c->bins * sizeof(B));
+        for (int k = n ? 1 : 0; k <= n; k++) { // The current window alone, or the n complete ones before it
+            B *w = chronoWindow(p, (c->window - k + c->windows) % c->windows);
+            for (int b = 0; b < c->bins; b++)
+                sum[b] += w[b];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (*(volatile uint32_t *)&p->seq != seq || *(volatile uint32_t *)&p->cseq != cseq)
+            continue;
+        c->binOffset = (char *)sum - (char *)c;
+        c->windows   = 0;
+        copy.histogram(h);
+        return true;
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// INSTANCES - each needs the histogram of the same bins
+//
+template class ChronoOf<uint16_t, 32>;
+template class ChronoOf<uint16_t, 101>;
+template class ChronoOf<uint32_t, 101>; // Chrono
+template class ChronoOf<uint32_t, 1001>;
+template class ChronoOf<uint64_t, 101>;
+template class ChronoOf<float, 101>;
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Versions
 
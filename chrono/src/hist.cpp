@@ -64,6 +64,7 @@
 
 #include "hist.h"
 #include <assert.h>
+#include <atomic>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -81,93 +82,111 @@ namespace Audinate { namespace hist {
 // not in the running profiled thread.  The only requirement being that Configure is not called instantly in
 // succession with increasing bin sizes.  That would just be silly.
 //
+// Snapshot gives a consistent copy with two seqlock counters, seq around each add and cseq around a reset or
+// config, as for Chrono.
+//
 
-typedef struct hist_t // Structure of the first 5 fields is used elsewhere (aud_interval) do not change
-{
-    char     name[64]; // Name of the histogram
-    int32_t  configs;  // Increments each time we reconfig (or reset) to let clients know bins have changed
-    HistFlag flags;    // For things like dither being enabled
-    float    bin0;     // The centre of the first bin
-    float    width;    // The width of each bin
-    int32_t  count;    // The number of times add has been called
-    int32_t  bins;     // The number of bins
-    HistType bin[101]; // The bin data
-    uint32_t rand;     // Linear congruent generated random number for stochastic resonance
-    HistType N;        // Sum of weight of adds - usually an integer but may not be equal to count unless adds are all n=1
-    float    sumX;     // Actual sum of random variable - not biased by bin range
-    float    sumX2;    // Actual sum of square of random variable - not biased by bin range but precision limited
-    float    min;      // Actual min value
-    float    max;      // Actual max value
-} Hist;
+template <typename B, int Bins> struct hist_t // Structure of the first 5 fields is used elsewhere (aud_interval) do not change
+{
+    char         name[64];  // Name of the histogram
+    int32_t      configs;   // Increments each time we reconfig (or reset) to let clients know bins have changed
+    HistFlag     flags;     // For things like dither being enabled
+    float        bin0;      // The centre of the first bin
+    float        width;     // The width of each bin
+    int32_t      count;     // The number of times add has been called
+    int32_t      bins;      // The number of bins
+    B            bin[Bins]; // The bin data
+    uint32_t     rand;      // Linear congruent generated random number for stochastic resonance
+    HistTotal<B> N;         // Sum of weight of adds - usually an integer but may not be equal to count unless adds are all n=1
+    float        sumX;      // Actual sum of random variable - not biased by bin range
+    float        sumX2;     // Actual sum of square of random variable - not biased by bin range but precision limited
+    float        min;       // Actual min value
+    float        max;       // Actual max value
+    uint32_t     seq;       // Odd while an add is underway
+    uint32_t     cseq;      // Odd while a reset or config is underway
+    float        recip;     // Reciprocal of the width for the batch adds
+};
+
+inline void histSeqBegin(volatile uint32_t *seq)
+{
+    *seq = *seq + 1;
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline void histSeqEnd(volatile uint32_t *seq)
+{
+    std::atomic_thread_fence(std::memory_order_release);
+    *seq = *seq + 1;
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // SIMPLE ACCESS
 //
 
-HistFlag Histogram::flags() const { return ((hist_t *)mData)->flags; }
+template <typename B, int Bins> HistFlag HistogramOf<B, Bins>::flags() const { return ((hist_t<B, Bins> *)mData)->flags; }
 
-float histMeanLin(const hist_t *p)
+template <typename B, int Bins> float histMeanLin(const hist_t<B, Bins> *p)
 {
     if (p != nullptr && p->N > 0)
         return p->sumX / p->N;
     return 0.0F;
 }
 
-float histStdLin(const hist_t *p)
+template <typename B, int Bins> float histStdLin(const hist_t<B, Bins> *p)
 {
     if (p != nullptr && p->N > 1)
         return sqrtf(fabsf((p->sumX2 - p->sumX * p->sumX / p->N) / (p->N - 1)));
     return 0.0F;
 }
-float histMaxLin(const hist_t *p)
+template <typename B, int Bins> float histMaxLin(const hist_t<B, Bins> *p)
 {
     if (p != nullptr)
         return p->max;
     return 0.0F;
 }
-float histMinLin(const hist_t *p)
+template <typename B, int Bins> float histMinLin(const hist_t<B, Bins> *p)
 {
     if (p != nullptr)
         return p->min;
     return 0.0F;
 }
-float histBincentLin(const hist_t *p, int bin)
+template <typename B, int Bins> float histBincentLin(const hist_t<B, Bins> *p, int bin)
 {
     if (p != nullptr && bin >= 0)
         return p->bin0 + bin * p->width;
     return 0.0F;
 }
-float histBinWidthLin(const hist_t *p)
+template <typename B, int Bins> float histBinWidthLin(const hist_t<B, Bins> *p)
 {
     if (p != nullptr)
         return p->width;
     return 1.0F;
 } // Defensive for divide edge case
 
-int      Histogram::bins() const { return ((hist_t *)mData)->bins; }
-HistType Histogram::bin(int bin) const
+template <typename B, int Bins> int HistogramOf<B, Bins>::bins() const { return ((hist_t<B, Bins> *)mData)->bins; }
+template <typename B, int Bins> B HistogramOf<B, Bins>::bin(int bin) const
 {
     if (bin < 0 || bin >= bins())
         return 0;
-    return ((hist_t *)mData)->bin[bin];
+    return ((hist_t<B, Bins> *)mData)->bin[bin];
 }
 
 inline uint32_t histRandNext(int x) { return x * 0x0019660d + 0x3c6ef35f; }; // Long term unbiased, but slower to converge and costs an extra multiply - From Numerical Recipes
 
-Histogram::Histogram()
+template <typename B, int Bins> HistogramOf<B, Bins>::HistogramOf()
 {
-    assert(sizeof(mData) >= sizeof(hist_t));
-    hist_t *p = (hist_t *)mData;
-    memset(p, 0, sizeof(hist_t)); // Most initialize to zero
+    assert(sizeof(mData) >= sizeof(hist_t<B, Bins>));
+    hist_t<B, Bins> *p = (hist_t<B, Bins> *)mData;
+    memset(p, 0, sizeof(hist_t<B, Bins>)); // Most initialize to zero
     p->width = 1.0F;              // code past config count = 0 to avoud /0
+    p->recip = 1.0F;
     strncpy(p->name, "HIST NOT CONFIGURED", sizeof(p->name) - 1);
 }
 
-Histogram::~Histogram() {}
+template <typename B, int Bins> HistogramOf<B, Bins>::~HistogramOf() {}
 
-void Histogram::reset() // Reset without changing the config - use sparingly as each client must recalibrate
+template <typename B, int Bins> void histClear(hist_t<B, Bins> *p) // Clear the data without touching the config or the add sequence
 {
-    hist_t *p = (hist_t *)mData;
     p->configs++;               // Only do this once
     for (int n = 0; n < 2; n++) // Clear all of the relevant fields, rinse and repeat
     {                           // just in case an update occurred part way through
@@ -178,24 +197,33 @@ void Histogram::reset() // Reset without changing the config - use sparingly as
         p->min   = 0;
         p->max   = 0;
         p->rand  = (int)(0.5F / 4294967296.0F);
-        memset(p->bin, 0, p->bins * sizeof(HistType));
+        memset(p->bin, 0, p->bins * sizeof(B));
     }
 }
 
-bool Histogram::config(float bin0, float binN, int bins, HistFlag flags, const char *name)
+template <typename B, int Bins> void HistogramOf<B, Bins>::reset() // Reset without changing the config - use sparingly as each client must recalibrate
 {
-    hist_t *p = (hist_t *)mData;
+    hist_t<B, Bins> *p = (hist_t<B, Bins> *)mData;
+    histSeqBegin(&p->cseq);
+    histClear(p);
+    histSeqEnd(&p->cseq);
+}
+
+template <typename B, int Bins> bool HistogramOf<B, Bins>::config(float bin0, float binN, int bins, HistFlag flags, const char *name)
+{
+    hist_t<B, Bins> *p = (hist_t<B, Bins> *)mData;
     if (bins <= 2)
         return false;
     if (binN <= bin0)
         return false;
 
-    if (bins > (sizeof(p->bin) / sizeof(HistType)))
-        bins = (sizeof(p->bin) / sizeof(HistType));
+    if (bins > Bins)
+        bins = Bins;
 
     if ((flags & LOGX) != false && bin0 == 0.0F)
         return false;
 
+    histSeqBegin(&p->cseq);
     p->flags = flags;
     if (flags & LOGX) {
         p->bin0  = logf(bin0);
@@ -204,20 +232,23 @@ bool Histogram::config(float bin0, float binN, int bins, HistFlag flags, const c
         p->bin0  = bin0;
         p->width = (binN - bin0) / (bins - 1);
     };
-    p->bins = bins;
+    p->recip = 1.0F / p->width;
+    p->bins  = bins;
     if (name == nullptr)
         p->name[0] = 0;
     else
         strncpy(p->name, name, sizeof(p->name) - 1);
-    reset();
+    histClear(p);
+    histSeqEnd(&p->cseq);
     return true;
 }
 
-void Histogram::add(float x, HistType n)
+template <typename B, int Bins> void HistogramOf<B, Bins>::add(float x, B n)
 {
-    hist_t *p = (hist_t *)mData;
+    hist_t<B, Bins> *p = (hist_t<B, Bins> *)mData;
     if (p->configs == 0)
         return;
+    histSeqBegin(&p->seq);
     int bin;
     if ((p->flags & LOGX) && x > 0.0F)
         x = logf(x);
@@ -233,21 +264,167 @@ void Histogram::add(float x, HistType n)
         bin = p->bins - 1;
     p->bin[bin] += n; // Atomic change to the histogram
     p->N += n;
-    p->sumX += x;
-    p->sumX2 += x * x;
+    p->sumX += n * x; // Weighted, as N is, so mean and std hold for weights other than 1
+    p->sumX2 += n * x * x;
     if (p->count == 0 || x > p->max)
         p->max = x; // Note the edge case of time 0 for max if x's are negative
     if (p->count == 0 || x < p->min)
         p->min = x; // Edge case for min if future xs are positive
     p->count++;
-    return;
+    histSeqEnd(&p->seq);
+}
+
+// For several writers, each field is updated atomically and the add sequence is left alone, so a snapshot of it
+// always succeeds but may see an add part done.  The moments are float adds by compare and swap, so the
+// contention cost grows with writers, and min and max may miss a value that races the very first add.
+//
+template <typename T> inline std::atomic<T> *histAtomic(T *v) { return (std::atomic<T> *)v; } // Same layout as T
+
+template <typename T> inline void histAtomicAdd(T *v, T x) // For floats
+{
+    std::atomic<T> *a = histAtomic(v);
+    T               c = a->load(std::memory_order_relaxed);
+    while (!a->compare_exchange_weak(c, c + x, std::memory_order_relaxed))
+        ;
+}
+
+inline void histAtomicAdd(uint16_t *v, uint16_t x) { histAtomic(v)->fetch_add(x, std::memory_order_relaxed); } // Counting bins add directly
+inline void histAtomicAdd(uint32_t *v, uint32_t x) { histAtomic(v)->fetch_add(x, std::memory_order_relaxed); }
+inline void histAtomicAdd(uint64_t *v, uint64_t x) { histAtomic(v)->fetch_add(x, std::memory_order_relaxed); }
+
+template <typename B, int Bins> void HistogramOf<B, Bins>::addAtomic(float x, B n)
+{
+    static_assert(sizeof(std::atomic<B>) == sizeof(B) && sizeof(std::atomic<HistTotal<B>>) == sizeof(HistTotal<B>) && sizeof(std::atomic<float>) == sizeof(float), "Atomics must overlay the fields");
+    hist_t<B, Bins> *p = (hist_t<B, Bins> *)mData;
+    if (p->configs == 0)
+        return;
+    int bin;
+    if ((p->flags & LOGX) && x > 0.0F)
+        x = logf(x);
+    if (p->flags & DITHER) { // A lost update of the generator only repeats a dither
+        uint32_t r = histRandNext(histAtomic(&p->rand)->load(std::memory_order_relaxed));
+        histAtomic(&p->rand)->store(r, std::memory_order_relaxed);
+        bin = (int)((x - p->bin0) / p->width + (float)r * (1.0F / 4294967296.0F));
+    } else
+        bin = (int)((x - p->bin0) / p->width + 0.5F);
+
+    if (bin < 0)
+        bin = 0;
+    if (bin >= p->bins)
+        bin = p->bins - 1;
+    histAtomicAdd(&p->bin[bin], n);
+    histAtomicAdd(&p->N, (HistTotal<B>)n);
+    histAtomicAdd(&p->sumX, n * x);
+    histAtomicAdd(&p->sumX2, n * x * x);
+    bool  first = histAtomic(&p->count)->fetch_add(1, std::memory_order_relaxed) == 0;
+    float c     = histAtomic(&p->max)->load(std::memory_order_relaxed);
+    while ((first || x > c) && !histAtomic(&p->max)->compare_exchange_weak(c, x, std::memory_order_relaxed))
+        ;
+    c = histAtomic(&p->min)->load(std::memory_order_relaxed);
+    while ((first || x < c) && !histAtomic(&p->min)->compare_exchange_weak(c, x, std::memory_order_relaxed))
+        ;
+}
+
+// The batch adds work in blocks so the bins are computed in straight loops the compiler can vectorize, with
+// the reciprocal width and a polynomial log2 in place of the divide and logf.  The dither is the same generator
+// sequence as add, run as interleaved lanes that each jump ahead eight steps with one multiply.  Each block sums
+// its moments in float and folds them into double for the batch, which keeps more precision than adding each
+// sample into the running float totals.  LOGX bins, moments and ends carry the error of the approximation.
+// The whole batch is one add sequence, so a snapshot sees all of it or none of it.
+//
+#define HIST_BLOCK 64 // Samples binned per block of a batch add
+#define HIST_LANES 8  // Interleaved runs of the dither generator
+
+inline float histLog(float x) // Natural log from the exponent and a quartic in the mantissa - log2 within 1.2e-4
+{
+    union {
+        float    f;
+        uint32_t i;
+    } u;
+    u.f     = x;
+    float e = (float)((int32_t)(u.i >> 23) - 127);
+    u.i     = (u.i & 0x007FFFFF) | 0x3F800000; // Mantissa in [1,2)
+    float t = u.f - 1.0F;                      // Exact at both ends so it stays monotonic across octaves
+    float l = t + t * (t - 1.0F) * (-0.43872569F + t * (0.23905804F + t * -0.08213054F));
+    return (e + l) * 0.69314718F;
+}
+
+template <typename B, int Bins, typename T> static void histAddBatch(hist_t<B, Bins> *p, const T *v, int count)
+{
+    if (p->configs == 0 || v == nullptr || count <= 0)
+        return;
+    histSeqBegin(&p->seq);
+    bool     logx   = (p->flags & LOGX) != 0;
+    bool     dither = (p->flags & DITHER) != 0;
+    float    bin0   = p->bin0;
+    float    recip  = p->recip;
+    float    top    = (float)(p->bins - 1);
+    uint32_t rand   = p->rand;
+    float    lo     = p->count ? p->min : v[0];
+    float    hi     = p->count ? p->max : v[0];
+    double   sumX   = 0;
+    double   sumX2  = 0;
+    if (p->count == 0 && logx && lo > 0.0F)
+        lo = hi = histLog(lo);
+
+    float    x[HIST_BLOCK];
+    float    d[HIST_BLOCK];
+    uint32_t r[HIST_BLOCK];
+    int32_t  b[HIST_BLOCK];
+    for (int k = 0; k < count; k += HIST_BLOCK) {
+        int m = count - k < HIST_BLOCK ? count - k : HIST_BLOCK;
+        for (int j = 0; j < m; j++)
+            x[j] = (float)v[k + j];
+        if (logx)
+            for (int j = 0; j < m; j++)
+                x[j] = x[j] > 0.0F ? histLog(x[j]) : x[j];
+        if (dither) {
+            int j = 0;
+            for (; j < m && j < HIST_LANES; j++)
+                r[j] = rand = histRandNext(rand);
+            for (; j < m; j++) // The same sequence, with each lane jumping ahead by the lane count
+                r[j] = r[j - HIST_LANES] * 0xea890021 + 0xa3d95fa8;
+            rand = r[m - 1];
+            for (j = 0; j < m; j++)
+                d[j] = (float)r[j] * (1.0F / 4294967296.0F);
+        } else
+            for (int j = 0; j < m; j++)
+                d[j] = 0.5F;
+        float sx = 0, sx2 = 0;
+        for (int j = 0; j < m; j++) {
+            float u = (x[j] - bin0) * recip + d[j];
+            u       = u < 0.0F ? 0.0F : u > top ? top : u;
+            b[j]    = (int32_t)u;
+            sx += x[j];
+            sx2 += x[j] * x[j];
+            lo = x[j] < lo ? x[j] : lo;
+            hi = x[j] > hi ? x[j] : hi;
+        }
+        for (int j = 0; j < m; j++)
+            p->bin[b[j]]++;
+        sumX += sx;
+        sumX2 += sx2;
+    }
+    p->rand  = rand;
+    p->N += count;
+    p->sumX  = (float)(p->sumX + sumX);
+    p->sumX2 = (float)(p->sumX2 + sumX2);
+    p->min   = lo;
+    p->max   = hi;
+    p->count += count;
+    histSeqEnd(&p->seq);
 }
 
-bool Histogram::reconfig(float bin0, float binN, int bins, HistFlag flags, uint32_t *bin, const char *name)
+template <typename B, int Bins> void HistogramOf<B, Bins>::add(const float *x, int count) { histAddBatch((hist_t<B, Bins> *)mData, x, count); }
+template <typename B, int Bins> void HistogramOf<B, Bins>::add(const int32_t *x, int count) { histAddBatch((hist_t<B, Bins> *)mData, x, count); }
+template <typename B, int Bins> void HistogramOf<B, Bins>::add(const int16_t *x, int count) { histAddBatch((hist_t<B, Bins> *)mData, x, count); }
+
+template <typename B, int Bins> bool HistogramOf<B, Bins>::reconfig(float bin0, float binN, int bins, HistFlag flags, B *bin, const char *name)
 {
     config(bin0, binN, bins, flags);
-    hist_t *p = (hist_t *)mData;
-    memcpy(p->bin, bin, p->bins * sizeof(HistType));
+    hist_t<B, Bins> *p = (hist_t<B, Bins> *)mData;
+    histSeqBegin(&p->cseq);
+    memcpy(p->bin, bin, p->bins * sizeof(B));
     for (int n = 0; n < bins; n++)
         p->N += bin[n];
     for (int n = 0; n < bins; n++)
@@ -268,6 +445,163 @@ bool Histogram::reconfig(float bin0, float binN, int bins, HistFlag flags, uint3
         p->name[0] = 0;
     else
         strncpy(p->name, name, sizeof(p->name) - 1);
+    histSeqEnd(&p->cseq);
+    return true;
+}
+
+template <typename B, int Bins> bool HistogramOf<B, Bins>::snapshot(HistogramOf *copy, int tries) const // Copy between even and unchanged reads of both counters
+{
+    const hist_t<B, Bins> *p = (const hist_t<B, Bins> *)mData;
+    hist_t<B, Bins> *      c = (hist_t<B, Bins> *)copy->mData;
+    assert(copy != this);
+    for (; tries > 0; tries--) {
+        uint32_t seq  = *(volatile uint32_t *)&p->seq;
+        uint32_t cseq = *(volatile uint32_t *)&p->cseq;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((seq | cseq) & 1)
+            continue;
+        memcpy(c, p, sizeof(hist_t<B, Bins>));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (*(volatile uint32_t *)&p->seq == seq && *(volatile uint32_t *)&p->cseq == cseq) {
+            c->seq  = 0;
+            c->cseq = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// COMBINING HISTOGRAMS
+//
+// Histograms with the same bins add bin for bin, which the compiler vectorizes, and the exact sums, count,
+// min and max carry across.  Otherwise each bin of the other is spread over the bins here that its range
+// overlaps, in proportion, as if the values were uniform within it, with the ends saturating as for add.
+// The shares are rounded on the running total so the count is kept exactly.  The exact sums carry across if
+// both are LOGX or both linear, as they are then in the same domain, or else they come from the bin centres.
+// The other is copied first by snapshot, so it may be live.  These update the bins between the add sequence
+// counts, as they are an add of many values, so are for the thread that owns this histogram.
+//
+
+template <typename B, int Bins> static bool histSame(const hist_t<B, Bins> *p, const hist_t<B, Bins> *q) // Bins line up exactly
+{
+    return p->bins == q->bins && p->bin0 == q->bin0 && p->width == q->width && (p->flags & LOGX) == (q->flags & LOGX);
+}
+
+static float histDomain(float x, bool fromLog, bool toLog) // A value from one binning domain to the other
+{
+    if (fromLog == toLog)
+        return x;
+    if (fromLog)
+        return expf(x);
+    return x > 0 ? logf(x) : -HUGE_VALF;
+}
+
+template <typename B, int Bins> static void histEnds(hist_t<B, Bins> *p) // Min and max from the populated bins, as reconfig does
+{
+    int n;
+    for (n = 0; n < p->bins && p->bin[n] == 0; n++)
+        ;
+    p->min = n < p->bins ? p->bin0 + n * p->width : 0;
+    for (n = p->bins - 1; n > 0 && p->bin[n] == 0; n--)
+        ;
+    p->max = p->bin[n] ? p->bin0 + n * p->width : 0;
+}
+
+template <typename B, int Bins> static void histRebin(hist_t<B, Bins> *p, const hist_t<B, Bins> *q) // Spread the bins of q over those of p
+{
+    bool  fromLog = q->flags & LOGX, toLog = p->flags & LOGX;
+    float top     = (float)p->bins + 1.0F;
+    for (int b = 0; b < q->bins; b++) {
+        B c = q->bin[b];
+        if (c == 0)
+            continue;
+        float lo = histDomain(q->bin0 + (b - 0.5F) * q->width, fromLog, toLog);
+        float hi = histDomain(q->bin0 + (b + 0.5F) * q->width, fromLog, toLog);
+        float u0 = fminf(fmaxf((lo - p->bin0) / p->width + 0.5F, -1.0F), top); // Position in bins of this
+        float u1 = fminf(fmaxf((hi - p->bin0) / p->width + 0.5F, -1.0F), top);
+        int   k0 = (int)floorf(u0), k1 = (int)ceilf(u1) - 1;
+        k0       = k0 < 0 ? 0 : k0 >= p->bins ? p->bins - 1 : k0;
+        k1       = k1 < k0 ? k0 : k1 >= p->bins ? p->bins - 1 : k1;
+        B given = 0;
+        for (int k = k0; k <= k1; k++) {
+            float    f = k == k1 || u1 <= u0 ? 1.0F : (fminf(u1, k + 1.0F) - u0) / (u1 - u0);
+            B     n = (B)(f * (double)c + 0.5) - given;
+            p->bin[k] += n;
+            given += n;
+        }
+        if (fromLog != toLog) { // Sums from the centre in the domain here, held to the range as log(0) has no place
+            float x = histDomain(q->bin0 + b * q->width, fromLog, toLog);
+            x       = fminf(fmaxf(x, p->bin0), p->bin0 + (p->bins - 1) * p->width);
+            p->sumX += c * x;
+            p->sumX2 += c * x * x;
+        }
+    }
+    if (fromLog == toLog) {
+        p->sumX += q->sumX;
+        p->sumX2 += q->sumX2;
+    }
+}
+
+template <typename B, int Bins> bool HistogramOf<B, Bins>::compatible(const HistogramOf *h) const { return histSame((hist_t<B, Bins> *)mData, (const hist_t<B, Bins> *)h->mData); }
+
+template <typename B, int Bins> bool HistogramOf<B, Bins>::merge(const HistogramOf *h, int tries)
+{
+    hist_t<B, Bins> *  p = (hist_t<B, Bins> *)mData;
+    HistogramOf copy;
+    hist_t<B, Bins> *  q = (hist_t<B, Bins> *)copy.mData;
+    if (!h->snapshot(&copy, tries) || q->configs == 0)
+        return false;
+    if (p->configs == 0) { // Take on the config of the first merged in
+        uint32_t cseq = p->cseq;
+        histSeqBegin(&p->cseq);
+        memcpy(p, q, sizeof(hist_t<B, Bins>));
+        p->cseq    = cseq + 1;
+        p->seq     = 0;
+        p->configs = 1;
+        histSeqEnd(&p->cseq);
+        return true;
+    }
+    bool  same = histSame(p, q), toLog = p->flags & LOGX, fromLog = q->flags & LOGX;
+    float qmin = histDomain(q->min, fromLog, toLog), qmax = histDomain(q->max, fromLog, toLog);
+    histSeqBegin(&p->seq);
+    if (same) {
+        for (int n = 0; n < p->bins; n++)
+            p->bin[n] += q->bin[n];
+        p->sumX += q->sumX;
+        p->sumX2 += q->sumX2;
+    } else
+        histRebin(p, q);
+    if (q->count > 0) {
+        p->min = p->count == 0 || qmin < p->min ? qmin : p->min;
+        p->max = p->count == 0 || qmax > p->max ? qmax : p->max;
+    }
+    p->N += q->N;
+    p->count += q->count;
+    histSeqEnd(&p->seq);
+    return true;
+}
+
+template <typename B, int Bins> bool HistogramOf<B, Bins>::subtract(const HistogramOf *h, int tries)
+{
+    hist_t<B, Bins> *  p = (hist_t<B, Bins> *)mData;
+    HistogramOf copy;
+    hist_t<B, Bins> *  q = (hist_t<B, Bins> *)copy.mData;
+    if (!h->snapshot(&copy, tries) || !histSame(p, q))
+        return false;
+    histSeqBegin(&p->seq);
+    HistTotal<B> N = 0;
+    for (int n = 0; n < p->bins; n++) {
+        B d = p->bin[n] > q->bin[n] ? q->bin[n] : p->bin[n]; // Saturate if it was not an earlier copy
+        p->bin[n] -= d;
+        N += d;
+    }
+    p->N -= N < p->N ? N : p->N;
+    p->sumX -= q->sumX;
+    p->sumX2 -= q->sumX2;
+    p->count -= q->count < p->count ? q->count : p->count;
+    histEnds(p); // The true extremes of what is left are lost, so bound them by the bins
+    histSeqEnd(&p->seq);
     return true;
 }
 
@@ -276,53 +610,52 @@ bool Histogram::reconfig(float bin0, float binN, int bins, HistFlag flags, uint3
 //
 //
 
-HistType histN(const hist_t *p, bool cull)
+template <typename B, int Bins> HistTotal<B> histN(const hist_t<B, Bins> *p, bool cull)
 {
     if (p == NULL || p->bins == 0 || p->bin == NULL)
         return 0;
     if (cull == false)
         return p->N;
-    HistType N = 0;
+    HistTotal<B> N = 0;
     for (int n = 1; n < p->bins - 1; n++)
         N += p->bin[n];
     return N;
 }
 
-HistType Histogram::n(bool cull) const { return histN((hist_t *)mData, cull); }
+template <typename B, int Bins> HistTotal<B> HistogramOf<B, Bins>::n(bool cull) const { return histN((hist_t<B, Bins> *)mData, cull); }
+
+template <typename B, int Bins> static float histCullSum(const hist_t<B, Bins> *p); // From the single pass below
 
-float histSum(const hist_t *p, bool cull)
+template <typename B, int Bins> float histSum(const hist_t<B, Bins> *p, bool cull)
 {
     if (p == NULL || p->bins == 0 || p->bin == NULL)
         return 0;
     if (cull == false)
         return p->sumX;
-    float S = 0;
-    for (int n = 1; n < p->bins - 1; n++)
-        S += p->bin[n] * (p->bin0 + p->width * n);
-    return S;
+    return histCullSum(p);
 }
 
-float Histogram::sum(bool cull) const { return histSum((hist_t *)mData, cull); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::sum(bool cull) const { return histSum((hist_t<B, Bins> *)mData, cull); }
 
-HistType histPeak(const hist_t *p, bool cull = false)
+template <typename B, int Bins> B histPeak(const hist_t<B, Bins> *p, bool cull = false)
 {
     if (p == NULL || p->bins <= 0 || p->bin == NULL)
         return 0;
-    HistType peak = p->bin[0];
+    B peak = p->bin[0];
     for (int n = 0 + (cull == true); n < p->bins - (cull == true); n++)
         if (p->bin[n] > peak)
             peak = p->bin[n];
     return peak;
 }
 
-HistType Histogram::peak(bool cull) const { return histPeak((hist_t *)mData, cull); }
+template <typename B, int Bins> B HistogramOf<B, Bins>::peak(bool cull) const { return histPeak((hist_t<B, Bins> *)mData, cull); }
 
-float histBinMaxLin(const hist_t *p)
+template <typename B, int Bins> float histBinMaxLin(const hist_t<B, Bins> *p)
 {
     if (p == nullptr || p->bins <= 0 || p->bin == NULL)
         return 0.0F;
     int bin = p->bins - 1;
-    while (bin >= 0 && p->bin[bin] == (HistType)0)
+    while (bin >= 0 && p->bin[bin] == (B)0)
         bin--;
     if (bin < 0)
         return p->bin0 + p->width * p->bins / 2.0F; // If no data - a bit arbitrary
@@ -330,11 +663,11 @@ float histBinMaxLin(const hist_t *p)
         return p->bin0 + p->width * (bin + 0.5F); // We cant be sure it wasn't up to the right edge
 }
 
-float histBinMinLin(const hist_t *p)
+template <typename B, int Bins> float histBinMinLin(const hist_t<B, Bins> *p)
 {
     assert(p != nullptr && p->bins > 0 && p->bin != nullptr);
     int bin = 0;
-    while (bin < p->bins && p->bin[bin] == (HistType)0)
+    while (bin < p->bins && p->bin[bin] == (B)0)
         bin++;
     if (bin < 0)
         return p->bin0 + p->width * p->bins / 2; // If no data - a bit arbitrary
@@ -342,72 +675,140 @@ float histBinMinLin(const hist_t *p)
         return p->bin0 + p->width * (bin - 0.5F); // We cant be sure it wasn't as low as the left edge
 }
 
-float histMomentLin(const hist_t *p, int order, bool cull)
+// The statistics from the bins come from one pass that sums the count and the first two moments of the bin index
+// as exact integers (doubles for float bins), so the loop is multiply adds that vectorize, with no powf per bin.
+// The scaling by the width and offset by bin0 is done once at the end.  The percentiles search a prefix sum of the
+// bins, built on the stack, so stats builds it once for all of its percentiles and the accessors only read.
+//
+template <typename B> struct hist_moment_t { typedef uint64_t type; }; // Exact for the counting bins
+template <> struct hist_moment_t<float> { typedef double type; };      // and as near as can be for weights
+
+template <typename B> struct hist_pass_t
 {
-    assert(p != nullptr && p->bins > 0 && p->bin != nullptr);
-    float sumn  = 0.0F;
-    float sumxo = 0.0F;
-    float x     = p->bin0 + p->width * (cull == true);
-    for (int b = 0 + (cull == true); b < p->bins - (cull == true); b++) {
-        sumn += p->bin[b];
-        sumxo += p->bin[b] * powf(x, (float)order);
-        x += p->width;
+    typedef typename hist_moment_t<B>::type M;
+
+    int lo, hi; // The bins included - all but the ends if culled
+    M   n;      // Sum of the bins
+    M   m1;     // Sum of bin x index
+    M   m2;     // Sum of bin x index^2
+    B   peak;   // Largest bin
+    int at;     // First bin holding the peak
+};
+
+template <typename B, int Bins> static void histPass(const hist_t<B, Bins> *p, bool cull, hist_pass_t<B> *r)
+{
+    typedef typename hist_pass_t<B>::M M;
+    M n = 0, m1 = 0, m2 = 0;
+    B peak = 0;
+    r->lo  = cull == true;
+    r->hi  = p->bins - (cull == true);
+    for (int b = r->lo; b < r->hi; b++) {
+        M v = p->bin[b];
+        n += v;
+        m1 += v * (M)b;
+        m2 += v * (M)(b * b);
+        peak = p->bin[b] > peak ? p->bin[b] : peak;
     }
-    if (sumn >= 0)
-        return sumxo / sumn;
-    else
+    r->at = r->lo;
+    while (r->at < r->hi - 1 && p->bin[r->at] != peak)
+        r->at++;
+    r->n    = n;
+    r->m1   = m1;
+    r->m2   = m2;
+    r->peak = peak;
+}
+
+template <typename B, int Bins> static float histCullSum(const hist_t<B, Bins> *p)
+{
+    hist_pass_t<B> r;
+    histPass(p, true, &r);
+    return p->bin0 * r.n + p->width * r.m1;
+}
+
+template <typename B, int Bins> static void histPrefix(const hist_t<B, Bins> *p, HistTotal<B> *cum) // The cumulative bins
+{
+    HistTotal<B> run = 0;
+    for (int b = 0; b < p->bins; b++)
+        cum[b] = run += p->bin[b];
+}
+
+template <typename B, int Bins> static float histPassMean(const hist_t<B, Bins> *p, const hist_pass_t<B> *r)
+{
+    if (r->n == 0)
         return 0.0F;
+    return p->bin0 + p->width * (float)((double)r->m1 / (double)r->n);
 }
 
-float histBinMeanLin(const hist_t *p, bool cull) { return histMomentLin(p, 1, cull); };
-float histBinStdLin(const hist_t *p, bool cull)
+template <typename B, int Bins> static float histPassStd(const hist_t<B, Bins> *p, const hist_pass_t<B> *r)
 {
-    float ux  = histMomentLin(p, 1, cull);
-    float ux2 = histMomentLin(p, 2, cull);
-    return sqrtf(ux2 - ux * ux);
+    if (r->n == 0)
+        return 0.0F;
+    double u   = (double)r->m1 / (double)r->n;
+    double var = (double)r->m2 / (double)r->n - u * u;
+    return p->width * (float)sqrt(var > 0 ? var : 0);
 }
 
-float histPercentLin(const hist_t *p, float percent, bool cull)
+template <typename B, int Bins> float histBinMeanLin(const hist_t<B, Bins> *p, bool cull)
 {
-    assert(p != nullptr && p->bins > 0 && p->bin != nullptr);
-    float sumn = 0.0F;
-    int   b;
-    for (b = 0 + (cull == true); b < p->bins - (cull == true); b++)
-        sumn += p->bin[b];
-    if (sumn == 0.0F)
-        return p->bin0 + p->width * p->bins / 2;
+    assert(p != nullptr && p->bins > 0);
+    hist_pass_t<B> r;
+    histPass(p, cull, &r);
+    return histPassMean(p, &r);
+}
 
-    float cut = percent / 100.0F * sumn;
-    sumn      = 0.0F;
-    for (b = 0 + (cull == true); b < p->bins - (cull == true) && sumn < cut; b++)
-        sumn += p->bin[b];
+template <typename B, int Bins> float histBinStdLin(const hist_t<B, Bins> *p, bool cull)
+{
+    assert(p != nullptr && p->bins > 0);
+    hist_pass_t<B> r;
+    histPass(p, cull, &r);
+    return histPassStd(p, &r);
+}
 
-    if (p->bin[b - 1] > (HistType)0)
-        return p->bin0 + (b - 0.5F - (sumn - cut) / p->bin[b - 1]) * p->width;
+template <typename B, int Bins> float histPercentLin(const hist_t<B, Bins> *p, float percent, bool cull, const HistTotal<B> *cum = nullptr)
+{
+    assert(p != nullptr && p->bins > 0);
+    HistTotal<B> own[Bins]; // Unless the caller has built one for several percentiles
+    if (cum == nullptr) {
+        histPrefix(p, own);
+        cum = own;
+    }
+    int                 lo    = cull == true;
+    int                 hi    = p->bins - (cull == true);
+    HistTotal<B>        base  = lo ? cum[lo - 1] : 0;
+    HistTotal<B>        total = cum[hi - 1] - base;
+    if (total == 0)
+        return p->bin0 + p->width * p->bins / 2;
+
+    double cut = percent / 100.0 * total; // First bin where the running sum reaches the cut
+    int    b   = lo;
+    for (int z = hi - 1; b < z;) {
+        int m = (b + z) / 2;
+        if (cum[m] - base >= cut)
+            z = m;
+        else
+            b = m + 1;
+    }
+    if (p->bin[b] > (B)0)
+        return p->bin0 + (b + 0.5F - (float)((cum[b] - base - cut) / p->bin[b])) * p->width;
     else
-        return p->bin0 + (b - 0.5F) * p->width;
+        return p->bin0 + (b + 0.5F) * p->width;
 }
 
-float histMedianLin(const hist_t *p, bool cull) { return histPercentLin(p, 50.0F, cull); };
+template <typename B, int Bins> float histMedianLin(const hist_t<B, Bins> *p, bool cull) { return histPercentLin(p, 50.0F, cull); };
 
-float histModeLin(const hist_t *p, bool cull)
+template <typename B, int Bins> float histModeLin(const hist_t<B, Bins> *p, bool cull)
 {
-    if (p == NULL || p->bins <= 0 || p->bin == NULL)
+    if (p == NULL || p->bins <= 0)
         return 0;
-    HistType peak = p->bin[0];
-    int      at   = 0;
-    for (int n = 0 + (cull == true); n < p->bins - (cull == true); n++)
-        if (p->bin[n] > peak) {
-            peak = p->bin[n];
-            at   = n;
-        };
+    hist_pass_t<B> r;
+    histPass(p, cull, &r);
 
     // TODO - do the spline and max finding here
 
-    return p->bin0 + at * p->width;
+    return p->bin0 + r.at * p->width;
 }
 
-float histBinMax(const hist_t *p)
+template <typename B, int Bins> float histBinMax(const hist_t<B, Bins> *p)
 {
     if (p->flags & LOGX)
         return expf(histBinMaxLin(p));
@@ -415,7 +816,7 @@ float histBinMax(const hist_t *p)
         return histBinMaxLin(p);
 }
 
-float histBinMin(const hist_t *p)
+template <typename B, int Bins> float histBinMin(const hist_t<B, Bins> *p)
 {
     if (p->flags & LOGX)
         return expf(histBinMinLin(p));
@@ -423,7 +824,7 @@ float histBinMin(const hist_t *p)
         return histBinMinLin(p);
 }
 // float aud_hist_moment (const hist_t* p, int o, bool c)	{ if (p->flags&LOGX) return expf(aud_hist_moment_lin(p,o,c)); else return histMomentLin(p,o,c); }
-float histBinMean(const hist_t *p, bool c)
+template <typename B, int Bins> float histBinMean(const hist_t<B, Bins> *p, bool c)
 {
     if (p->flags & LOGX)
         return expf(histBinMeanLin(p, c));
@@ -431,9 +832,9 @@ float histBinMean(const hist_t *p, bool c)
         return histBinMeanLin(p, c);
 }
 
-float Histogram::binMean(bool cull) const { return histBinMean((hist_t *)mData, cull); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::binMean(bool cull) const { return histBinMean((hist_t<B, Bins> *)mData, cull); }
 
-float histBinStd(const hist_t *p, bool c)
+template <typename B, int Bins> float histBinStd(const hist_t<B, Bins> *p, bool c)
 {
     if (p->flags & LOGX)
         return expf(histBinStdLin(p, c));
@@ -441,9 +842,9 @@ float histBinStd(const hist_t *p, bool c)
         return histBinStdLin(p, c);
 }
 
-float Histogram::binStd(bool cull) const { return histBinStd((hist_t *)mData, cull); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::binStd(bool cull) const { return histBinStd((hist_t<B, Bins> *)mData, cull); }
 
-float histPercent(const hist_t *p, float f, bool c)
+template <typename B, int Bins> float histPercent(const hist_t<B, Bins> *p, float f, bool c)
 {
     if (p->flags & LOGX)
         return expf(histPercentLin(p, f, c));
@@ -451,9 +852,9 @@ float histPercent(const hist_t *p, float f, bool c)
         return histPercentLin(p, f, c);
 }
 
-float Histogram::percent(float percent, bool cull) const { return histPercent((hist_t *)mData, percent, cull); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::percent(float percent, bool cull) const { return histPercent((hist_t<B, Bins> *)mData, percent, cull); }
 
-float histMedian(const hist_t *p, bool c)
+template <typename B, int Bins> float histMedian(const hist_t<B, Bins> *p, bool c)
 {
     if (p->flags & LOGX)
         return expf(histMedianLin(p, c));
@@ -461,9 +862,9 @@ float histMedian(const hist_t *p, bool c)
         return histMedianLin(p, c);
 }
 
-float Histogram::median(bool cull) const { return histMedian((hist_t *)mData, cull); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::median(bool cull) const { return histMedian((hist_t<B, Bins> *)mData, cull); }
 
-float histMode(const hist_t *p, bool c)
+template <typename B, int Bins> float histMode(const hist_t<B, Bins> *p, bool c)
 {
     if (p->flags & LOGX)
         return expf(histModeLin(p, c));
@@ -471,9 +872,9 @@ float histMode(const hist_t *p, bool c)
         return histModeLin(p, c);
 }
 
-float Histogram::mode(bool cull) const { return histMode((hist_t *)mData, cull); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::mode(bool cull) const { return histMode((hist_t<B, Bins> *)mData, cull); }
 
-float histMean(const hist_t *p)
+template <typename B, int Bins> float histMean(const hist_t<B, Bins> *p)
 {
     if (p->flags & LOGX)
         return expf(histMeanLin(p));
@@ -481,9 +882,9 @@ float histMean(const hist_t *p)
         return histMeanLin(p);
 }
 
-float Histogram::mean() const { return histMean((hist_t *)mData); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::mean() const { return histMean((hist_t<B, Bins> *)mData); }
 
-float histStd(const hist_t *p)
+template <typename B, int Bins> float histStd(const hist_t<B, Bins> *p)
 {
     if (p->flags & LOGX)
         return expf(histStdLin(p)) * histMean(p);
@@ -491,9 +892,9 @@ float histStd(const hist_t *p)
         return histStdLin(p);
 }
 
-float Histogram::std() const { return histStd((hist_t *)mData); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::std() const { return histStd((hist_t<B, Bins> *)mData); }
 
-float histMax(const hist_t *p)
+template <typename B, int Bins> float histMax(const hist_t<B, Bins> *p)
 {
     if (p->flags & LOGX)
         return expf(histMaxLin(p));
@@ -501,9 +902,9 @@ float histMax(const hist_t *p)
         return histMaxLin(p);
 }
 
-float Histogram::max() const { return histMax((hist_t *)mData); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::max() const { return histMax((hist_t<B, Bins> *)mData); }
 
-float histMin(const hist_t *p)
+template <typename B, int Bins> float histMin(const hist_t<B, Bins> *p)
 {
     if (p->flags & LOGX)
         return expf(histMinLin(p));
@@ -511,9 +912,9 @@ float histMin(const hist_t *p)
         return histMinLin(p);
 }
 
-float Histogram::min() const { return histMin((hist_t *)mData); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::min() const { return histMin((hist_t<B, Bins> *)mData); }
 
-float histBinCenter(const hist_t *p, int n)
+template <typename B, int Bins> float histBinCenter(const hist_t<B, Bins> *p, int n)
 {
     if (p->flags & LOGX)
         return expf(histBincentLin(p, n));
@@ -521,9 +922,9 @@ float histBinCenter(const hist_t *p, int n)
         return histBincentLin(p, n);
 }
 
-float Histogram::binCenter(int bin) const { return histBinCenter((hist_t *)mData, bin); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::binCenter(int bin) const { return histBinCenter((hist_t<B, Bins> *)mData, bin); }
 
-float histBinWidth(const hist_t *p)
+template <typename B, int Bins> float histBinWidth(const hist_t<B, Bins> *p)
 {
     if (p->flags & LOGX)
         return expf(histBinWidthLin(p));
@@ -531,7 +932,36 @@ float histBinWidth(const hist_t *p)
         return histBinWidthLin(p);
 }
 
-float Histogram::binWidth() const { return histBinWidth((hist_t *)mData); }
+template <typename B, int Bins> float HistogramOf<B, Bins>::binWidth() const { return histBinWidth((hist_t<B, Bins> *)mData); }
+
+template <typename B, int Bins> static float histX(const hist_t<B, Bins> *p, float x) { return (p->flags & LOGX) ? expf(x) : x; } // From the binning domain
+
+template <typename B, int Bins> bool histStats(const hist_t<B, Bins> *p, HistStatsOf<B> *s, bool cull, const float *percents, int count)
+{
+    memset(s, 0, sizeof(HistStatsOf<B>));
+    if (p == nullptr || p->bins <= 2 || p->configs == 0)
+        return false;
+    hist_pass_t<B> r;
+    histPass(p, cull, &r);
+    s->n       = cull ? (HistTotal<B>)r.n : p->N;
+    s->sum     = cull ? p->bin0 * r.n + p->width * r.m1 : p->sumX; // As histCullSum
+    s->binMean = histX(p, histPassMean(p, &r));
+    s->binStd  = histX(p, histPassStd(p, &r));
+    s->mean    = cull ? s->binMean : histMean(p);
+    s->std     = cull ? s->binStd : histStd(p);
+    s->min     = histMin(p);
+    s->max     = histMax(p);
+    s->mode    = histX(p, p->bin0 + r.at * p->width);
+    s->peak    = r.peak;
+    HistTotal<B> cum[Bins] = {}; // Off the real time path, and quiets a false maybe uninitialized in Release
+    histPrefix(p, cum);
+    s->median = histX(p, histPercentLin(p, 50.0F, cull, cum));
+    for (int k = 0; k < count && k < HIST_PERCENTS; k++)
+        s->percent[k] = histX(p, histPercentLin(p, percents[k], cull, cum));
+    return true;
+}
+
+template <typename B, int Bins> bool HistogramOf<B, Bins>::stats(HistStatsOf<B> *s, bool cull, const float *percents, int count) const { return histStats((hist_t<B, Bins> *)mData, s, cull, percents, count); }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // ASCII PLOT
@@ -548,7 +978,7 @@ const char symbolsAscii[] = {(char)5, ' ', '_', '.', 'x', 'X'}; //   _.xX
 
 #define symbol(symbols, x) (symbols[max(0, min(symbols[0] - 1, (int)((x)*symbols[0] + 0.5))) + 1])
 
-bool histText(const hist_t *p, int barHeight, char *str, HistTextOption flags, int yMax, const char *symbols)
+template <typename B, int Bins> bool histText(const hist_t<B, Bins> *p, int barHeight, char *str, HistTextOption flags, int yMax, const char *symbols)
 {
     if (p == nullptr || p->bins == 0 || p->bin == nullptr)
         return false;
@@ -622,83 +1052,37 @@ bool histText(const hist_t *p, int barHeight, char *str, HistTextOption flags, i
     }
 
     if ((flags & STATS) && p->bins > 20 && barHeight > 8) {
-        int   line = 1;
-        bool  cull = flags & CULL;
-        float x;
-        char  tmp[20];
+        int       line = 1;
+        HistStatsOf<B> st;
+        histStats(p, &st, flags & CULL, nullptr, 0);
+        struct
+        {
+            HistTextOption option;
+            const char *   format;
+            float          value;
+        } rows[] = {
+            { SUM, "|sum   %11.3E|", st.sum },
+            { MEAN, "|mean  %11.3E|", st.mean },
+            { STD, "|std   %11.3E|", st.std },
+            { MEDIAN, "|median%11.3E|", st.median },
+            { MODE, "|mode  %11.3E|", st.mode },
+            { MIN, "|min   %11.3E|", st.min },
+            { MAX, "|max   %11.3E|", st.max },
+        };
+        char tmp[20];
 
         if (flags & TOTAL) {
-            unsigned int N = histN(p, cull);
-            snprintf(tmp, 20, "|total %11d|", N);
-            for (int n = 0; n < 19; n++) {
-                str[pos(n + p->bins - 22 + 2 * ylabel, line)] = tmp[n];
-            };
-            line++;
-        }
-
-        if (flags & SUM) {
-            float S = histSum(p, cull);
-            snprintf(tmp, 20, "|sum   %11.3E|", S);
-            for (int n = 0; n < 19; n++) {
-                str[pos(n + p->bins - 22 + 2 * ylabel, line)] = tmp[n];
-            };
-            line++;
-        }
-
-        if (flags & MEAN) {
-            if (!cull)
-                x = histMean(p);
-            else
-                x = histBinMean(p, cull);
-            snprintf(tmp, 20, "|mean  %11.3E|", x);
+            snprintf(tmp, 20, "|total %11.0f|", (double)st.n);
             for (int n = 0; n < 19; n++) {
                 str[pos(n + p->bins - 22 + 2 * ylabel, line)] = tmp[n];
             };
             line++;
         }
 
-        if (flags & STD) {
-            if (!cull)
-                x = histStd(p);
-            else
-                x = histBinStd(p, cull);
-            snprintf(tmp, 20, "|std   %11.3E|", x);
-            for (int n = 0; n < 19; n++) {
-                str[pos(n + p->bins - 22 + 2 * ylabel, line)] = tmp[n];
-            };
-            line++;
-        }
-
-        if (flags & MEDIAN) {
-            x = histMedian(p, cull);
-            snprintf(tmp, 20, "|median%11.3E|", x);
-            for (int n = 0; n < 19; n++) {
-                str[pos(n + p->bins - 22 + 2 * ylabel, line)] = tmp[n];
-            };
-            line++;
-        }
-
-        if (flags & MODE) {
-            x = histMode(p, cull);
-            snprintf(tmp, 20, "|mode  %11.3E|", x);
-            for (int n = 0; n < 19; n++) {
-                str[pos(n + p->bins - 22 + 2 * ylabel, line)] = tmp[n];
-            };
-            line++;
-        }
-
-        if (flags & MIN) {
-            x = histMin(p);
-            snprintf(tmp, 20, "|min   %11.3E|", x);
-            for (int n = 0; n < 19; n++) {
-                str[pos(n + p->bins - 22 + 2 * ylabel, line)] = tmp[n];
-            };
-            line++;
-        }
-
-        if (flags & MAX) {
-            x = histMax(p);
-            snprintf(tmp, 20, "|max   %11.3E|", x);
+        for (unsigned int r = 0; r < sizeof(rows) / sizeof(rows[0]); r++) {
+            if (!(flags & rows[r].option))
+                continue;
+            snprintf(tmp, 20, rows[r].format, rows[r].value);
             for (int n = 0; n < 19; n++) {
                 str[pos(n + p->bins - 22 + 2 * ylabel, line)] = tmp[n];
             };
@@ -737,7 +1121,17 @@ bool histText(const hist_t *p, int barHeight, char *str, HistTextOption flags, i
     return true;
 }
 
-bool Histogram::text(int barHeight, char *str, HistTextOption flags, int yMax, const char *symbols) const { return histText((hist_t *)mData, barHeight, str, flags, yMax, symbols); }
+template <typename B, int Bins> bool HistogramOf<B, Bins>::text(int barHeight, char *str, HistTextOption flags, int yMax, const char *symbols) const { return histText((hist_t<B, Bins> *)mData, barHeight, str, flags, yMax, symbols); }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// INSTANCES
+//
+template class HistogramOf<uint16_t, 32>;   // Many small ones
+template class HistogramOf<uint16_t, 101>;  //
+template class HistogramOf<uint32_t, 101>;  // Histogram
+template class HistogramOf<uint32_t, 1001>; // Fine resolution
+template class HistogramOf<uint64_t, 101>;  // Long running counters
+template class HistogramOf<float, 101>;     // Weighted data
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Versions
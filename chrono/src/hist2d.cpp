@@ -0,0 +1,309 @@
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+//
+// hist2d.cpp
+//
+
+#include "hist2d.h"
+#include <assert.h>
+#include <atomic>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace Audinate { namespace hist {
+
+struct hist2d_axis_t
+{
+    float    bin0;  // The centre of the first bin, in the binning domain
+    float    width; // The width of each bin
+    float    recip; // Reciprocal of the width
+    int32_t  bins;  // The number of bins
+    HistFlag flags; // DITHER, LOGX and COUNTER
+};
+
+struct hist2d_t
+{
+    char          name[64];           // Name of the histogram
+    int32_t       configs;            // Increments each time we config or reset
+    int32_t       count;              // The number of times add has been called
+    hist2d_axis_t axis[2];            // X then Y
+    uint32_t      rand;               // Linear congruent generator for the dither, shared by the axes
+    HistType      N;                  // Sum of weight of adds
+    uint32_t      seq;                // Odd while an add is underway
+    uint32_t      cseq;               // Odd while a reset or config is underway
+    double        sx, sy;             // Exact sums of the weighted values
+    double        sxx, syy, sxy;      // and of their squares and product
+    HistType      bin[HIST2D_CELLS];  // The cells, x fastest
+};
+
+inline void hist2dSeqBegin(volatile uint32_t *seq) // As for Histogram
+{
+    *seq = *seq + 1;
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline void hist2dSeqEnd(volatile uint32_t *seq)
+{
+    std::atomic_thread_fence(std::memory_order_release);
+    *seq = *seq + 1;
+}
+
+inline uint32_t hist2dRandNext(uint32_t x) { return x * 0x0019660d + 0x3c6ef35f; } // As histRandNext
+
+static bool hist2dAxis(hist2d_axis_t *a, float v0, float vN, int bins, HistFlag flags)
+{
+    if (bins <= 2 || bins > HIST_BINS || vN <= v0)
+        return false;
+    if ((flags & LOGX) && v0 <= 0.0F)
+        return false;
+    a->flags = flags;
+    a->bins  = bins;
+    if (flags & LOGX) {
+        a->bin0  = logf(v0);
+        a->width = (logf(vN) - a->bin0) / (bins - 1);
+    } else {
+        a->bin0  = v0;
+        a->width = (vN - v0) / (bins - 1);
+        if (flags & COUNTER) // Whole numbers each fall in one bin
+            a->width = a->width < 1.0F ? 1.0F : floorf(a->width + 0.5F);
+    }
+    a->recip = 1.0F / a->width;
+    return true;
+}
+
+inline int hist2dBin(const hist2d_axis_t *a, float v, float dither) // Of a value already in the binning domain
+{
+    int bin = (int)((v - a->bin0) * a->recip + dither);
+    if (bin < 0)
+        bin = 0;
+    if (bin >= a->bins)
+        bin = a->bins - 1;
+    return bin;
+}
+
+inline float hist2dDomain(const hist2d_axis_t *a, float v) { return ((a->flags & LOGX) && v > 0.0F) ? logf(v) : v; }
+
+static void hist2dClear(hist2d_t *p)
+{
+    p->configs++;
+    p->count = 0;
+    p->N     = 0;
+    p->rand  = 0;
+    p->sx = p->sy = p->sxx = p->syy = p->sxy = 0.0;
+    memset(p->bin, 0, sizeof(p->bin));
+}
+
+Histogram2D::Histogram2D()
+{
+    assert(sizeof(mData) >= sizeof(hist2d_t)); // Ensure hidden data allocation is sufficient
+    hist2d_t *p = (hist2d_t *)mData;
+    memset(p, 0, sizeof(hist2d_t));
+    p->axis[AXIS_X].width = p->axis[AXIS_Y].width = 1.0F;
+    p->axis[AXIS_X].recip = p->axis[AXIS_Y].recip = 1.0F;
+    strncpy(p->name, "HIST2D NOT CONFIGURED", sizeof(p->name) - 1);
+}
+
+Histogram2D::~Histogram2D() {}
+
+bool Histogram2D::config(float x0, float xN, int xBins, HistFlag xFlags, float y0, float yN, int yBins, HistFlag yFlags, const char *name)
+{
+    hist2d_t *    p = (hist2d_t *)mData;
+    hist2d_axis_t x, y;
+    if (!hist2dAxis(&x, x0, xN, xBins, xFlags) || !hist2dAxis(&y, y0, yN, yBins, yFlags) || xBins * yBins > HIST2D_CELLS)
+        return false;
+    hist2dSeqBegin(&p->cseq);
+    p->axis[AXIS_X] = x;
+    p->axis[AXIS_Y] = y;
+    if (name == nullptr)
+        p->name[0] = 0;
+    else
+        strncpy(p->name, name, sizeof(p->name) - 1);
+    hist2dClear(p);
+    hist2dSeqEnd(&p->cseq);
+    return true;
+}
+
+void Histogram2D::reset()
+{
+    hist2d_t *p = (hist2d_t *)mData;
+    hist2dSeqBegin(&p->cseq);
+    hist2dClear(p);
+    hist2dSeqEnd(&p->cseq);
+}
+
+void Histogram2D::add(float x, float y, HistType n)
+{
+    hist2d_t *p = (hist2d_t *)mData;
+    if (p->configs == 0)
+        return;
+    const hist2d_axis_t *ax = &p->axis[AXIS_X];
+    const hist2d_axis_t *ay = &p->axis[AXIS_Y];
+    hist2dSeqBegin(&p->seq);
+    x          = hist2dDomain(ax, x);
+    y          = hist2dDomain(ay, y);
+    float dx   = 0.5F, dy = 0.5F; // Simple rounding unless dithered
+    if (ax->flags & DITHER)
+        dx = (float)(p->rand = hist2dRandNext(p->rand)) * (1.0F / 4294967296.0F);
+    if (ay->flags & DITHER)
+        dy = (float)(p->rand = hist2dRandNext(p->rand)) * (1.0F / 4294967296.0F);
+    p->bin[hist2dBin(ay, y, dy) * ax->bins + hist2dBin(ax, x, dx)] += n;
+    p->N += n;
+    p->sx += (double)n * x;
+    p->sy += (double)n * y;
+    p->sxx += (double)n * x * x;
+    p->syy += (double)n * y * y;
+    p->sxy += (double)n * x * y;
+    p->count++;
+    hist2dSeqEnd(&p->seq);
+}
+
+bool Histogram2D::snapshot(Histogram2D *copy, int tries) const // Copy between even and unchanged reads of both counters
+{
+    const hist2d_t *p = (const hist2d_t *)mData;
+    hist2d_t *      c = (hist2d_t *)copy->mData;
+    assert(copy != this);
+    for (; tries > 0; tries--) {
+        uint32_t seq  = *(volatile uint32_t *)&p->seq;
+        uint32_t cseq = *(volatile uint32_t *)&p->cseq;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((seq | cseq) & 1)
+            continue;
+        memcpy(c, p, sizeof(hist2d_t));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (*(volatile uint32_t *)&p->seq == seq && *(volatile uint32_t *)&p->cseq == cseq) {
+            c->seq  = 0;
+            c->cseq = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Histogram2D::marginal(Histogram *h, HistAxis axis, int from, int to, int tries) const // Read from a snapshot so the sums are of one instant
+{
+    Histogram2D s;
+    if (!snapshot(&s, tries))
+        return false;
+    const hist2d_t *     p = (const hist2d_t *)s.mData;
+    const hist2d_axis_t *a = &p->axis[axis];
+    const hist2d_axis_t *o = &p->axis[1 - axis];
+    if (p->configs == 0)
+        return false;
+    if (to < 0 || to >= o->bins)
+        to = o->bins - 1;
+    if (from < 0)
+        from = 0;
+    HistType sum[HIST_BINS] = { 0 };
+    for (int k = from; k <= to; k++)
+        for (int b = 0; b < a->bins; b++)
+            sum[b] += axis == AXIS_X ? p->bin[k * a->bins + b] : p->bin[b * o->bins + k];
+    return h->reconfig(s.binCenter(axis, 0), s.binCenter(axis, a->bins - 1), a->bins, a->flags, sum, p->name);
+}
+
+float Histogram2D::correlation(int tries) const // Pearson, of the exact values, in the binning domain of each axis
+{
+    Histogram2D s;
+    if (!snapshot(&s, tries))
+        return 0.0F;
+    const hist2d_t *p = (const hist2d_t *)s.mData;
+    if (p->N < 2)
+        return 0.0F;
+    double n   = p->N;
+    double vxx = p->sxx - p->sx * p->sx / n;
+    double vyy = p->syy - p->sy * p->sy / n;
+    double cxy = p->sxy - p->sx * p->sy / n;
+    if (vxx <= 0.0 || vyy <= 0.0)
+        return 0.0F;
+    return (float)(cxy / sqrt(vxx * vyy));
+}
+
+HistType Histogram2D::n() const { return ((const hist2d_t *)mData)->N; }
+
+int Histogram2D::bins(HistAxis axis) const { return ((const hist2d_t *)mData)->axis[axis].bins; }
+
+int Histogram2D::bin(HistAxis axis, float v) const
+{
+    const hist2d_axis_t *a = &((const hist2d_t *)mData)->axis[axis];
+    return hist2dBin(a, hist2dDomain(a, v), 0.5F);
+}
+
+float Histogram2D::binCenter(HistAxis axis, int bin) const
+{
+    const hist2d_axis_t *a = &((const hist2d_t *)mData)->axis[axis];
+    float                v = a->bin0 + bin * a->width;
+    return (a->flags & LOGX) ? expf(v) : v;
+}
+
+float Histogram2D::mean(HistAxis axis) const // Geometric for a LOGX axis, as for Histogram::mean
+{
+    const hist2d_t *p = (const hist2d_t *)mData;
+    if (p->N == 0)
+        return 0.0F;
+    float m = (float)((axis == AXIS_X ? p->sx : p->sy) / p->N);
+    return (p->axis[axis].flags & LOGX) ? expf(m) : m;
+}
+
+HistType Histogram2D::cell(int x, int y) const
+{
+    const hist2d_t *p = (const hist2d_t *)mData;
+    if (x < 0 || x >= p->axis[AXIS_X].bins || y < 0 || y >= p->axis[AXIS_Y].bins)
+        return 0;
+    return p->bin[y * p->axis[AXIS_X].bins + x];
+}
+
+const char *Histogram2D::name() const { return ((const hist2d_t *)mData)->name; }
+
+}} // namespace Audinate::hist
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
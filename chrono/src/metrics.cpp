@@ -0,0 +1,277 @@
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+//
+// metrics.cpp
+//
+
+#ifdef _WIN32
+#include <io.h>
+#define write _write
+#else
+#include <unistd.h>
+#endif
+
+#include "metrics.h"
+#include <assert.h>
+#include <math.h>
+#include <new>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace Audinate { namespace chrono {
+
+struct metrics_t
+{
+    char *    buf;      // Caller buffer
+    int       size;     // Its size
+    int       len;      // Text in it so far
+    int       fd;       // Where to write when full - -1 for none
+    int       overflow; // A line was dropped
+    Histogram h;        // Scratch for the histogram of a chrono
+    Chrono    c;        // Scratch copy of a chrono
+    uint32_t  pool[METRICS_POOL];
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TEXT
+//
+// Each line is formatted straight into the buffer.  If it does not fit, it is taken back, the buffer is
+// flushed if there is an fd and the line tried again, or else dropped.
+//
+
+static void metricsLine(metrics_t *p, const char *fmt, ...)
+{
+    for (int pass = 0; pass < 2; pass++) {
+        int     room = p->size - p->len;
+        va_list args;
+        va_start(args, fmt);
+        int n = room > 0 ? vsnprintf(p->buf + p->len, room, fmt, args) : -1;
+        va_end(args);
+        if (n >= 0 && n < room) {
+            p->len += n;
+            return;
+        }
+        if (p->len < p->size)
+            p->buf[p->len] = 0; // Take back the part line
+        if (pass > 0 || p->fd < 0 || p->len == 0 || write(p->fd, p->buf, p->len) != p->len)
+            break;
+        p->len = 0;
+    }
+    p->overflow = 1;
+}
+
+static const char *metricsLabels(const char *labels, const char *open) // "{labels" or "{" so a le can follow
+{
+    return labels != nullptr && labels[0] ? open : "";
+}
+
+static float metricsEdge(const Histogram *h, int n) // Upper edge of a bin
+{
+    if (h->flags() & LOGX)
+        return h->binCenter(n) * sqrtf(h->binWidth());
+    return h->binCenter(n) + 0.5F * h->binWidth();
+}
+
+static double metricsSum(const Histogram *h, uint64_t *count, bool *negative) // From the bin centres
+{
+    double sum = 0;
+    *count     = 0;
+    *negative  = false;
+    for (int n = 0; n < h->bins(); n++) {
+        sum += (double)h->bin(n) * h->binCenter(n);
+        *count += h->bin(n);
+        if (h->bin(n) > 0 && h->binCenter(n) < 0)
+            *negative = true;
+    }
+    return sum;
+}
+
+static const Histogram *metricsChrono(metrics_t *p, Chrono *c) // A consistent histogram of the chrono if possible
+{
+    if (c->snapshot(&p->c, p->pool, METRICS_POOL) >= 0)
+        p->c.histogram(&p->h);
+    else
+        c->histogram(&p->h);
+    return &p->h;
+}
+
+Metrics::Metrics(char *buffer, int size, int fd)
+{
+    assert(sizeof(mData) >= sizeof(metrics_t)); // Ensure hidden data allocation is sufficient
+    memset(mData, 0, sizeof(metrics_t));
+    metrics_t *p = (metrics_t *)mData;
+    new (&p->h) Histogram();
+    new (&p->c) Chrono();
+    p->buf  = buffer;
+    p->size = size;
+    p->fd   = fd;
+    if (size > 0)
+        buffer[0] = 0;
+}
+
+Metrics::~Metrics() {}
+
+void Metrics::family(const char *name, const char *type, const char *help, const char *unit)
+{
+    metrics_t *p = (metrics_t *)mData;
+    metricsLine(p, "# TYPE %s %s\n", name, type);
+    if (unit != nullptr)
+        metricsLine(p, "# UNIT %s %s\n", name, unit);
+    if (help != nullptr)
+        metricsLine(p, "# HELP %s %s\n", name, help);
+}
+
+void Metrics::histogram(const char *name, const Histogram *h, const char *labels, bool sparse)
+{
+    metrics_t *p     = (metrics_t *)mData;
+    const char *l    = labels != nullptr ? labels : "";
+    const char *sep  = metricsLabels(labels, ",");
+    uint64_t    cum  = 0;
+    int         last = h->bins() - 1;
+    for (int n = 0; n < last; n++) {
+        cum += h->bin(n);
+        if (sparse && h->bin(n) == 0)
+            continue; // Cumulative, so a missing bucket loses nothing
+        metricsLine(p, "%s_bucket{%s%sle=\"%.6g\"} %llu\n", name, l, sep, metricsEdge(h, n), (unsigned long long)cum);
+    }
+    uint64_t count;
+    bool     negative;
+    double   sum = metricsSum(h, &count, &negative);
+    metricsLine(p, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, l, sep, (unsigned long long)count);
+    if (negative)
+        return; // The count and sum go together, and a sum is not allowed with negative values
+    metricsLine(p, "%s_count%s%s%s %llu\n", name, metricsLabels(labels, "{"), l, metricsLabels(labels, "}"), (unsigned long long)count);
+    metricsLine(p, "%s_sum%s%s%s %.9g\n", name, metricsLabels(labels, "{"), l, metricsLabels(labels, "}"), sum);
+}
+
+void Metrics::histogram(const char *name, Chrono *c, const char *labels, bool sparse)
+{
+    histogram(name, metricsChrono((metrics_t *)mData, c), labels, sparse);
+}
+
+void Metrics::summary(const char *name, const Histogram *h, const char *labels)
+{
+    metrics_t * p   = (metrics_t *)mData;
+    const char *l   = labels != nullptr ? labels : "";
+    const char *sep = metricsLabels(labels, ",");
+    uint64_t    count;
+    bool        negative;
+    double      sum = metricsSum(h, &count, &negative);
+    static const float quantile[] = { 0.5F, 0.9F, 0.99F };
+    for (float q : quantile)
+        metricsLine(p, "%s{%s%squantile=\"%g\"} %.6g\n", name, l, sep, q, count ? h->percent(q * 100.0F) : NAN);
+    if (negative)
+        return; // As for the histogram
+    metricsLine(p, "%s_count%s%s%s %llu\n", name, metricsLabels(labels, "{"), l, metricsLabels(labels, "}"), (unsigned long long)count);
+    metricsLine(p, "%s_sum%s%s%s %.9g\n", name, metricsLabels(labels, "{"), l, metricsLabels(labels, "}"), sum);
+}
+
+void Metrics::summary(const char *name, Chrono *c, const char *labels)
+{
+    summary(name, metricsChrono((metrics_t *)mData, c), labels);
+}
+
+void Metrics::gauge(const char *name, double value, const char *labels)
+{
+    metrics_t *p = (metrics_t *)mData;
+    metricsLine(p, "%s%s%s%s %.9g\n", name, metricsLabels(labels, "{"), labels != nullptr ? labels : "", metricsLabels(labels, "}"), value);
+}
+
+void Metrics::eof() { metricsLine((metrics_t *)mData, "# EOF\n"); }
+
+int Metrics::flush()
+{
+    metrics_t *p = (metrics_t *)mData;
+    int        n = p->len;
+    if (p->fd < 0 || (n > 0 && write(p->fd, p->buf, n) != n))
+        return -1;
+    clear();
+    return n;
+}
+
+void Metrics::clear()
+{
+    metrics_t *p = (metrics_t *)mData;
+    p->len       = 0;
+    p->overflow  = 0;
+    if (p->size > 0)
+        p->buf[0] = 0;
+}
+
+const char *Metrics::text() { return ((metrics_t *)mData)->buf; }
+int         Metrics::length() { return ((metrics_t *)mData)->len; }
+bool        Metrics::overflow() { return ((metrics_t *)mData)->overflow != 0; }
+
+int Metrics::label(char *str, int size, const char *name, const char *value)
+{
+    int len = (int)strnlen(str, size);
+    int n   = snprintf(str + len, size - len, "%s%s=\"", len ? "," : "", name);
+    len     = n < size - len ? len + n : size - 1;
+    for (; *value && len < size - 3; value++) { // Room for an escape and the closing quote
+        char c = *value == '\n' ? 'n' : *value;
+        if (*value == '\\' || *value == '"' || *value == '\n')
+            str[len++] = '\\';
+        str[len++] = c;
+    }
+    if (len < size - 1)
+        str[len++] = '"';
+    str[len] = 0;
+    return len;
+}
+
+}} // namespace Audinate::chrono
+
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
\ No newline at end of file
@@ -0,0 +1,274 @@
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+//
+// perf.cpp
+//
+
+#if defined(__linux__) && !defined(CHRONO_NO_PERF)
+#define CHRONO_PERF
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "perf.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace Audinate { namespace chrono {
+
+#define PERF_POOL (928) // Bins for the log-linear counts
+
+struct perf_t
+{
+    int      fd[PERF_COUNTERS];    // File for each counter - -1 if not opened
+    int      slot[PERF_COUNTERS];  // Position of each counter in the group read - -1 if not opened
+    uint64_t start[PERF_COUNTERS]; // Counts at begin
+    int      leader;               // File of the group leader - -1 if nothing is open
+    int      n;                    // Counters in the group
+    uint64_t enabled, running;     // Group times at begin - less running than enabled if the PMU was shared out
+    uint64_t begun;                // Set between a good begin and the end
+    Chrono   chrono[PERF_COUNTERS];
+    uint32_t pool[PERF_POOL];
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// PLATFORM DEPENDENT COUNTERS
+//
+// The group is read as { nr, time enabled, time running, value[nr] }.  Each counter is tried with the kernel
+// included first and then user space only, which perf_event_paranoid 2 still allows.
+//
+#ifdef CHRONO_PERF
+static int perfOpen(uint32_t type, uint64_t config, int leader)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size        = sizeof(attr);
+    attr.type        = type;
+    attr.config      = config;
+    attr.disabled    = leader < 0; // The group starts when it is all open
+    attr.exclude_hv  = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC);
+    if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+        attr.exclude_kernel = 1;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC);
+    }
+    return fd;
+}
+
+static bool perfRead(perf_t *p, uint64_t *buf) // False if the group could not be read whole
+{
+    ssize_t size = (ssize_t)((3 + p->n) * sizeof(uint64_t));
+    return read(p->leader, buf, size) == size && buf[0] == (uint64_t)p->n;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// PERF
+//
+
+Perf::Perf()
+{
+    assert(sizeof(mData) >= sizeof(perf_t)); // Ensure hidden data allocation is sufficient
+
+    perf_t *p = (perf_t *)mData;
+    memset(mData, 0, sizeof(perf_t));
+    p->leader = -1;
+    for (int c = 0; c < PERF_COUNTERS; c++) {
+        p->fd[c]   = -1;
+        p->slot[c] = -1;
+    }
+}
+
+Perf::~Perf() { close(); }
+
+bool Perf::open(const char *name)
+{
+    perf_t *p = (perf_t *)mData;
+    close();
+
+    static const char *label[PERF_COUNTERS] = { "CYCLES", "INSTRUCTIONS", "L1D READ MISSES", "LLC MISSES", "CONTEXT SWITCHES" };
+    char full[64];
+    int  used = 0;
+    for (int c = 0; c < CONTEXT_SWITCHES; c++) {
+        float lowest  = c < L1D_MISSES ? 32 : 1; // Exact to 32 cycles or 32 misses then 1 digit
+        float highest = c < L1D_MISSES ? 1e7F : 1e5F;
+        int   bins    = Chrono::logLinBins(lowest, highest, 1, COUNTER);
+        assert(used + bins <= PERF_POOL);
+        snprintf(full, sizeof(full), "%s%s%s PER CALL", name ? name : "", name ? " " : "", label[c]);
+        p->chrono[c].configLogLin(lowest, highest, 1, COUNTER, full, p->pool + used, bins);
+        used += bins;
+    }
+    snprintf(full, sizeof(full), "%s%s%s PER CALL", name ? name : "", name ? " " : "", label[CONTEXT_SWITCHES]);
+    p->chrono[CONTEXT_SWITCHES].config(0, 100, 101, COUNTER, full);
+
+#ifdef CHRONO_PERF
+    static const struct
+    {
+        uint32_t type;
+        uint64_t config;
+    } event[PERF_COUNTERS] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    };
+
+    for (int c = 0; c < PERF_COUNTERS; c++) {
+        p->fd[c] = perfOpen(event[c].type, event[c].config, p->leader);
+        if (p->fd[c] < 0)
+            continue; // Not on this platform - leave it out
+        if (p->leader < 0)
+            p->leader = p->fd[c];
+        p->slot[c] = p->n++;
+    }
+    if (p->leader >= 0)
+        ioctl(p->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+
+    return p->leader >= 0;
+}
+
+void Perf::close()
+{
+    perf_t *p = (perf_t *)mData;
+#ifdef CHRONO_PERF
+    for (int c = PERF_COUNTERS - 1; c >= 0; c--) // Members before the leader
+        if (p->fd[c] >= 0)
+            ::close(p->fd[c]);
+#endif
+    for (int c = 0; c < PERF_COUNTERS; c++) {
+        p->fd[c]   = -1;
+        p->slot[c] = -1;
+    }
+    p->leader = -1;
+    p->n      = 0;
+    p->begun  = 0;
+}
+
+bool Perf::available(perf_counter c)
+{
+    perf_t *p = (perf_t *)mData;
+    if (c < 0 || c >= PERF_COUNTERS)
+        return p->leader >= 0;
+    return p->slot[c] >= 0;
+}
+
+void Perf::reset()
+{
+    perf_t *p = (perf_t *)mData;
+    for (int c = 0; c < PERF_COUNTERS; c++)
+        p->chrono[c].reset();
+}
+
+void Perf::begin()
+{
+    perf_t *p = (perf_t *)mData;
+    p->begun = 0;
+#ifdef CHRONO_PERF
+    uint64_t buf[3 + PERF_COUNTERS];
+    if (p->leader < 0 || !perfRead(p, buf))
+        return;
+    p->enabled = buf[1];
+    p->running = buf[2];
+    for (int c = 0; c < PERF_COUNTERS; c++)
+        if (p->slot[c] >= 0)
+            p->start[c] = buf[3 + p->slot[c]];
+    p->begun = 1;
+#endif
+}
+
+void Perf::end(int weight)
+{
+    perf_t *p = (perf_t *)mData;
+    if (!p->begun || weight <= 0)
+        return;
+    p->begun = 0;
+#ifdef CHRONO_PERF
+    uint64_t buf[3 + PERF_COUNTERS];
+    if (!perfRead(p, buf))
+        return;
+    uint64_t enabled = buf[1] - p->enabled;
+    uint64_t running = buf[2] - p->running;
+    if (running == 0)
+        return; // The group was not on the PMU at all - nothing to record
+    for (int c = 0; c < PERF_COUNTERS; c++) {
+        if (p->slot[c] < 0)
+            continue;
+        uint64_t delta = buf[3 + p->slot[c]] - p->start[c];
+        if (running < enabled) // Shared with other groups, so scale up for the time it was off
+            delta = (uint64_t)((double)delta * (double)enabled / (double)running);
+        p->chrono[c].add(delta > 0x7FFFFFFF ? 0x7FFFFFFF : (int)delta, weight);
+    }
+#endif
+}
+
+Chrono *Perf::chrono(perf_counter c)
+{
+    assert(c >= 0 && c < PERF_COUNTERS);
+    if (c < 0 || c >= PERF_COUNTERS)
+        c = CYCLES; // Return a sensible safe default
+    return &((perf_t *)mData)->chrono[c];
+}
+
+}} // namespace Audinate::chrono
+
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
\ No newline at end of file
@@ -0,0 +1,690 @@
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+//
+// record.cpp
+//
+
+#if defined(__linux__) || defined(__APPLE__)
+#define CHRONO_RECORD
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "record.h"
+#include <assert.h>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Audinate { namespace chrono {
+
+#define RECORD_BINS    101                                       // Most bins a histogram has
+#define RECORD_HEADER  16                                        // Bytes before the first frame
+#define RECORD_VERSION 1                                         //
+#define RECORD_FRAME   (1 + 5 + 5 + 64 + 1 + 5 + 5 + 5 + 5 + 8 + RECORD_BINS * 10) // Most bytes one series adds to a frame
+
+enum record_tag { SESSION = 1, NAME, KEY, DELTA };
+
+struct record_series_t
+{
+    Chrono * chrono;            // Being recorded, or nullptr for a free slot
+    char     name[64];          // Name in the file
+    int32_t  id;                // Id for this session
+    int32_t  named;             // NAME written this session
+    int32_t  sinceKey;          // Changed samples since the last key frame
+    int32_t  configs;           // As of the last frame, to spot a reset or config
+    int32_t  flags;             //
+    int32_t  bins;              // 0 until the first key frame
+    float    bin0, binN;        //
+    uint32_t bin[RECORD_BINS];  // As of the last frame
+};
+
+struct recorder_t
+{
+    record_series_t *series;    // Table of the series
+    uint8_t *        buf;       // One frame
+    int64_t          bytes;     // Written since open
+    int              fd;        // The file, -1 if not open
+    int              capacity;  // Series in the table
+    int              keyFrames; // Changed samples between key frames
+    int              nextId;    // Ids are not reused within a session
+    Histogram        h;         // Scratch for the histogram of a chrono
+    Chrono           c;         // Scratch copy of a chrono
+    uint32_t         pool[RECORD_POOL];
+    int              session;   // The next frame starts a session
+};
+
+struct recording_t
+{
+    const uint8_t *map;    // The file mapped read only
+    int64_t        size;   // Bytes mapped
+    int64_t        end;    // End of the last complete frame
+    int            fd;     // -1 if not open
+    int            frames; // Complete frames
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ENCODING
+//
+// Varints are little endian base 128 with the top bit set on all but the last byte.  Reads are bounded and
+// return nullptr at the end of the data, which is how a part frame is found.
+//
+
+static uint8_t *recordVarint(uint8_t *b, uint64_t v)
+{
+    while (v >= 0x80) {
+        *b++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *b++ = (uint8_t)v;
+    return b;
+}
+
+static const uint8_t *recordRead(const uint8_t *b, const uint8_t *end, uint64_t *v)
+{
+    *v = 0;
+    for (int shift = 0; b != nullptr && b < end && shift < 64; shift += 7) {
+        *v |= (uint64_t)(*b & 0x7F) << shift;
+        if ((*b++ & 0x80) == 0)
+            return b;
+    }
+    return nullptr;
+}
+
+static uint8_t *recordFloat(uint8_t *b, float f)
+{
+    memcpy(b, &f, 4);
+    return b + 4;
+}
+
+static const uint8_t *recordReadFloat(const uint8_t *b, const uint8_t *end, float *f)
+{
+    if (b == nullptr || end - b < 4)
+        return nullptr;
+    memcpy(f, b, 4);
+    return b + 4;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// WALKING THE FRAMES
+//
+// Every record is decoded into an item and checked to be whole before the visitor sees it.  The bins of KEY
+// and DELTA are left as varints at data for the visitor to read again if it wants them.
+//
+
+struct record_item_t
+{
+    uint64_t       time;
+    int            frame;
+    uint64_t       tag, id, configs, flags, bins, changed;
+    float          bin0, binN;
+    const char *   name;
+    uint64_t       nameLen;
+    const uint8_t *data, *end;
+};
+
+typedef bool (*RecordVisitor)(void *context, const record_item_t *item); // Return false to stop
+
+static const uint8_t *recordItem(const uint8_t *b, const uint8_t *end, record_item_t *r) // One record, nullptr if bad
+{
+    uint64_t v;
+    r->end = end;
+    b      = recordRead(b, end, &r->tag);
+    if (r->tag != SESSION)
+        b = recordRead(b, end, &r->id);
+    switch (r->tag) {
+    case SESSION:
+        return b;
+    case NAME:
+        b = recordRead(b, end, &r->nameLen);
+        if (b == nullptr || (uint64_t)(end - b) < r->nameLen)
+            return nullptr;
+        r->name = (const char *)b;
+        return b + r->nameLen;
+    case KEY:
+        b = recordRead(b, end, &r->configs);
+        b = recordRead(b, end, &r->flags);
+        b = recordRead(b, end, &r->bins);
+        b = recordReadFloat(b, end, &r->bin0);
+        b = recordReadFloat(b, end, &r->binN);
+        if (b == nullptr || r->bins < 2 || r->bins > RECORD_BINS)
+            return nullptr;
+        r->data = b;
+        for (uint64_t n = 0; n < r->bins; n++)
+            b = recordRead(b, end, &v);
+        return b;
+    case DELTA:
+        b = recordRead(b, end, &r->changed);
+        if (b == nullptr || r->changed > RECORD_BINS)
+            return nullptr;
+        r->data = b;
+        for (uint64_t n = 0; n < 2 * r->changed; n++)
+            b = recordRead(b, end, &v);
+        return b;
+    }
+    return nullptr;
+}
+
+static int64_t recordWalk(const recording_t *p, uint64_t timeNs, RecordVisitor visit, void *context, int *frames = nullptr) // End of the frames walked
+{
+    const uint8_t *b   = p->map + RECORD_HEADER;
+    const uint8_t *end = p->map + p->size;
+    record_item_t  r;
+    for (r.frame = 0; b < end; r.frame++) {
+        uint64_t       length;
+        const uint8_t *frame = recordRead(b, end, &length);
+        if (frame == nullptr || (uint64_t)(end - frame) < length)
+            break;
+        const uint8_t *next = frame + length;
+        frame = recordRead(frame, next, &r.time);
+        if (frame == nullptr || r.time > timeNs)
+            break;
+        while (frame != nullptr && frame < next) {
+            frame = recordItem(frame, next, &r);
+            if (frame != nullptr && visit != nullptr && !visit(context, &r))
+                return b - p->map;
+        }
+        if (frame == nullptr)
+            break;
+        b = next;
+    }
+    if (frames != nullptr)
+        *frames = r.frame;
+    return b - p->map;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// RECORDER
+//
+
+Recorder::Recorder()
+{
+    assert(sizeof(mData) >= sizeof(recorder_t)); // Ensure hidden data allocation is sufficient
+    memset(mData, 0, sizeof(recorder_t));
+    recorder_t *p = (recorder_t *)mData;
+    new (&p->h) Histogram();
+    new (&p->c) Chrono();
+    p->fd = -1;
+}
+
+Recorder::~Recorder() { close(); }
+
+bool Recorder::open(const char *path, int series, int keyFrames)
+{
+    recorder_t *p = (recorder_t *)mData;
+    close();
+#ifdef CHRONO_RECORD
+    if (series < 1)
+        return false;
+    p->fd = ::open(path, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (p->fd < 0)
+        return false;
+    Recording   existing; // Find the end of the last whole frame to append after
+    recording_t *e  = (recording_t *)existing.mData;
+    struct stat  st;
+    bool         ok = fstat(p->fd, &st) == 0;
+    if (ok && st.st_size == 0) {
+        uint32_t header[RECORD_HEADER / 4] = { RECORD_MAGIC, RECORD_VERSION, RECORD_HEADER, 0 };
+        ok = write(p->fd, header, RECORD_HEADER) == RECORD_HEADER;
+    } else if (ok) {
+        ok = existing.open(path) && ftruncate(p->fd, e->end) == 0; // Drops any part frame
+    }
+    existing.close();
+    p->series = (record_series_t *)calloc(series, sizeof(record_series_t));
+    p->buf    = (uint8_t *)malloc(series * RECORD_FRAME + 32);
+    if (!ok || p->series == nullptr || p->buf == nullptr) {
+        close();
+        return false;
+    }
+    p->capacity  = series;
+    p->keyFrames = keyFrames > 0 ? keyFrames : 0x7FFFFFFF;
+    p->session   = 1;
+    return true;
+#else
+    (void)path;
+    (void)series;
+    (void)keyFrames;
+    return false;
+#endif
+}
+
+void Recorder::close()
+{
+    recorder_t *p = (recorder_t *)mData;
+#ifdef CHRONO_RECORD
+    if (p->fd >= 0)
+        ::close(p->fd);
+#endif
+    free(p->series);
+    free(p->buf);
+    p->series   = nullptr;
+    p->buf      = nullptr;
+    p->fd       = -1;
+    p->capacity = 0;
+    p->nextId   = 0;
+    p->bytes    = 0;
+}
+
+bool Recorder::add(Chrono *c, const char *name)
+{
+    recorder_t *p = (recorder_t *)mData;
+    for (int n = 0; n < p->capacity; n++) {
+        record_series_t *s = &p->series[n];
+        if (s->chrono != nullptr)
+            continue;
+        memset(s, 0, sizeof(record_series_t));
+        s->chrono = c;
+        s->id     = p->nextId++;
+        strncpy(s->name, name, sizeof(s->name) - 1);
+        return true;
+    }
+    return false;
+}
+
+void Recorder::remove(const Chrono *c)
+{
+    recorder_t *p = (recorder_t *)mData;
+    for (int n = 0; n < p->capacity; n++)
+        if (p->series[n].chrono == c)
+            p->series[n].chrono = nullptr;
+}
+
+int64_t Recorder::bytes() { return ((recorder_t *)mData)->bytes; }
+
+static uint8_t *recordSeries(recorder_t *p, record_series_t *s, uint8_t *b) // Append the records for a changed series
+{
+    Histogram *h = &p->h;
+    if (s->chrono->snapshot(&p->c, p->pool, RECORD_POOL) < 0)
+        return b; // Try again next time
+    p->c.histogram(h);
+
+    int   configs = p->c.configCount();
+    int   flags   = (int)h->flags();
+    int   bins    = h->bins() < RECORD_BINS ? h->bins() : RECORD_BINS;
+    float bin0    = h->binCenter(0);
+    float binN    = h->binCenter(bins - 1);
+    bool  key     = s->bins == 0 || configs != s->configs || flags != s->flags || bins != s->bins || bin0 != s->bin0 || binN != s->binN;
+    int   changed = 0;
+    for (int n = 0; n < bins && !key; n++) {
+        if (h->bin(n) < s->bin[n])
+            key = true; // Went backwards so it must have been reset
+        changed += h->bin(n) != s->bin[n];
+    }
+    if (!key && changed == 0)
+        return b;
+    if (!key && ++s->sinceKey >= p->keyFrames)
+        key = true;
+
+    if (!s->named) {
+        int length = (int)strlen(s->name);
+        b = recordVarint(b, NAME);
+        b = recordVarint(b, s->id);
+        b = recordVarint(b, length);
+        memcpy(b, s->name, length);
+        b += length;
+        s->named = 1;
+    }
+    if (key) {
+        b = recordVarint(b, KEY);
+        b = recordVarint(b, s->id);
+        b = recordVarint(b, configs);
+        b = recordVarint(b, flags);
+        b = recordVarint(b, bins);
+        b = recordFloat(b, bin0);
+        b = recordFloat(b, binN);
+        for (int n = 0; n < bins; n++)
+            b = recordVarint(b, h->bin(n));
+        s->sinceKey = 0;
+    } else {
+        b = recordVarint(b, DELTA);
+        b = recordVarint(b, s->id);
+        b = recordVarint(b, changed);
+        for (int n = 0, last = 0; n < bins; n++) {
+            if (h->bin(n) == s->bin[n])
+                continue;
+            b    = recordVarint(b, n - last);
+            b    = recordVarint(b, h->bin(n) - s->bin[n]);
+            last = n + 1;
+        }
+    }
+    for (int n = 0; n < bins; n++)
+        s->bin[n] = h->bin(n);
+    s->configs = configs;
+    s->flags   = flags;
+    s->bins    = bins;
+    s->bin0    = bin0;
+    s->binN    = binN;
+    return b;
+}
+
+int Recorder::sample(uint64_t timeNs)
+{
+    recorder_t *p = (recorder_t *)mData;
+    if (p->fd < 0)
+        return -1;
+    if (timeNs == 0)
+        timeNs = Chrono::source(REALTIME)(nullptr);
+
+    uint8_t *start = p->buf + 10; // Room for the length in front
+    uint8_t *b     = recordVarint(start, timeNs);
+    uint8_t *body  = b;
+    if (p->session) {
+        b = recordVarint(b, SESSION);
+        for (int n = 0; n < p->capacity; n++)
+            p->series[n].named = 0;
+    }
+    for (int n = 0; n < p->capacity; n++)
+        if (p->series[n].chrono != nullptr)
+            b = recordSeries(p, &p->series[n], b);
+    if (b == body)
+        return 0; // Nothing changed
+
+    uint8_t  length[10];
+    int      n = (int)(recordVarint(length, b - start) - length);
+    start     -= n;
+    memcpy(start, length, n);
+#ifdef CHRONO_RECORD
+    if (write(p->fd, start, b - start) != b - start)
+        return -1;
+#endif
+    p->session = 0;
+    p->bytes  += b - start;
+    return (int)(b - start);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// RECORDING
+//
+// A query walks the frames from the start, following the one series by its name through each session.  Even
+// hours of frames are only a few MB, so this is quick enough for looking back without keeping an index.
+//
+
+Recording::Recording()
+{
+    assert(sizeof(mData) >= sizeof(recording_t)); // Ensure hidden data allocation is sufficient
+    memset(mData, 0, sizeof(recording_t));
+    ((recording_t *)mData)->fd = -1;
+}
+
+Recording::~Recording() { close(); }
+
+bool Recording::open(const char *path)
+{
+    recording_t *p = (recording_t *)mData;
+    close();
+#ifdef CHRONO_RECORD
+    p->fd = ::open(path, O_RDONLY);
+    if (p->fd < 0 || !refresh()) {
+        close();
+        return false;
+    }
+    const uint32_t *header = (const uint32_t *)p->map;
+    if (header[0] != RECORD_MAGIC || header[1] != RECORD_VERSION || header[2] != RECORD_HEADER) {
+        close();
+        return false;
+    }
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void Recording::close()
+{
+    recording_t *p = (recording_t *)mData;
+#ifdef CHRONO_RECORD
+    if (p->map != nullptr)
+        munmap((void *)p->map, p->size);
+    if (p->fd >= 0)
+        ::close(p->fd);
+#endif
+    memset(p, 0, sizeof(recording_t));
+    p->fd = -1;
+}
+
+
+bool Recording::refresh()
+{
+    recording_t *p = (recording_t *)mData;
+#ifdef CHRONO_RECORD
+    struct stat st;
+    if (p->fd < 0 || fstat(p->fd, &st) != 0 || st.st_size < RECORD_HEADER)
+        return false;
+    if (p->map != nullptr)
+        munmap((void *)p->map, p->size);
+    p->map  = (const uint8_t *)mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, p->fd, 0);
+    p->size = st.st_size;
+    if (p->map == MAP_FAILED) {
+        p->map  = nullptr;
+        p->size = 0;
+        return false;
+    }
+    p->end = recordWalk(p, ~(uint64_t)0, nullptr, nullptr, &p->frames);
+    return true;
+#else
+    return false;
+#endif
+}
+
+int Recording::frames() { return ((recording_t *)mData)->frames; }
+
+struct record_find_t
+{
+    int      frame; // Frame to find
+    uint64_t time;  // Its time
+};
+
+static bool recordFrameTime(void *context, const record_item_t *r)
+{
+    record_find_t *f = (record_find_t *)context;
+    f->time          = r->time;
+    return r->frame < f->frame;
+}
+
+uint64_t Recording::frameNs(int frame)
+{
+    recording_t * p = (recording_t *)mData;
+    record_find_t f = { frame, 0 };
+    if (p->map == nullptr || frame < 0 || frame >= p->frames)
+        return 0;
+    recordWalk(p, ~(uint64_t)0, recordFrameTime, &f);
+    return f.time;
+}
+
+struct record_names_t
+{
+    const recording_t *p;
+    int                n;      // Distinct names still to pass over
+    char *             name;   // Where the nth goes
+    int                size;   //
+    int                length; // Its length, -1 until found
+    const char *       seek;   // Looking for an earlier NAME record like this one
+    uint64_t           seekLen;
+    bool               seen;
+};
+
+static bool recordEarlier(void *context, const record_item_t *r) // Stops at seek itself or an earlier copy
+{
+    record_names_t *f = (record_names_t *)context;
+    if (r->tag != NAME)
+        return true;
+    if (r->name == f->seek)
+        return false;
+    f->seen = r->nameLen == f->seekLen && memcmp(r->name, f->seek, f->seekLen) == 0;
+    return !f->seen;
+}
+
+static bool recordName(void *context, const record_item_t *r)
+{
+    record_names_t *f = (record_names_t *)context;
+    if (r->tag != NAME)
+        return true;
+    f->seek    = r->name;
+    f->seekLen = r->nameLen;
+    f->seen    = false;
+    recordWalk(f->p, ~(uint64_t)0, recordEarlier, f);
+    if (f->seen || f->n-- > 0)
+        return true;
+    f->length = r->nameLen < (uint64_t)f->size ? (int)r->nameLen : f->size - 1;
+    memcpy(f->name, r->name, f->length);
+    f->name[f->length] = 0;
+    return false;
+}
+
+int Recording::series(int n, char *name, int size)
+{
+    recording_t *  p = (recording_t *)mData;
+    record_names_t f = { p, n, name, size, -1, nullptr, 0, false };
+    if (p->map == nullptr || size < 1)
+        return -1;
+    recordWalk(p, ~(uint64_t)0, recordName, &f);
+    return f.length;
+}
+
+struct record_state_t
+{
+    const char *name;       // Series being followed
+    uint64_t    nameLen;    //
+    int64_t     id;         // Its id in this session, -1 if not named yet
+    int         session;    // Sessions so far
+    int         keySession; // Session the bins are from
+    bool        valid;      // A key frame has been seen
+    uint64_t    configs, flags, bins;
+    float       bin0, binN;
+    uint32_t    bin[RECORD_BINS];
+};
+
+static bool recordReplay(void *context, const record_item_t *r)
+{
+    record_state_t *st = (record_state_t *)context;
+    const uint8_t * b  = r->data;
+    uint64_t        v, gap;
+    switch (r->tag) {
+    case SESSION:
+        st->session++;
+        st->id = -1;
+        break;
+    case NAME:
+        if (r->nameLen == st->nameLen && memcmp(r->name, st->name, st->nameLen) == 0)
+            st->id = (int64_t)r->id;
+        break;
+    case KEY:
+        if ((int64_t)r->id != st->id)
+            break;
+        for (uint64_t n = 0; n < r->bins; n++) {
+            b          = recordRead(b, r->end, &v);
+            st->bin[n] = (uint32_t)v;
+        }
+        st->configs    = r->configs;
+        st->flags      = r->flags;
+        st->bins       = r->bins;
+        st->bin0       = r->bin0;
+        st->binN       = r->binN;
+        st->keySession = st->session;
+        st->valid      = true;
+        break;
+    case DELTA:
+        if ((int64_t)r->id != st->id || !st->valid)
+            break;
+        for (uint64_t n = 0, at = 0; n < r->changed; n++, at++) {
+            b = recordRead(b, r->end, &gap);
+            b = recordRead(b, r->end, &v);
+            at += gap;
+            if (at < st->bins)
+                st->bin[at] += (uint32_t)v;
+        }
+        break;
+    }
+    return true;
+}
+
+static bool recordState(const recording_t *p, const char *name, uint64_t timeNs, record_state_t *st)
+{
+    memset(st, 0, sizeof(record_state_t));
+    st->name    = name;
+    st->nameLen = strlen(name);
+    st->id      = -1;
+    if (p->map != nullptr)
+        recordWalk(p, timeNs, recordReplay, st);
+    return st->valid;
+}
+
+bool Recording::histogram(const char *name, uint64_t timeNs, Histogram *h)
+{
+    record_state_t st;
+    if (!recordState((recording_t *)mData, name, timeNs, &st))
+        return false;
+    return h->reconfig(st.bin0, st.binN, (int)st.bins, (HistFlag)st.flags, st.bin, name);
+}
+
+bool Recording::histogram(const char *name, uint64_t fromNs, uint64_t toNs, Histogram *h) // Since a reset if one was between
+{
+    record_state_t from, to;
+    if (!recordState((recording_t *)mData, name, toNs, &to))
+        return false;
+    bool same = recordState((recording_t *)mData, name, fromNs, &from) && from.keySession == to.keySession && from.configs == to.configs &&
+                from.flags == to.flags && from.bins == to.bins && from.bin0 == to.bin0 && from.binN == to.binN;
+    for (uint64_t n = 0; n < to.bins && same; n++)
+        same = to.bin[n] >= from.bin[n];
+    for (uint64_t n = 0; n < to.bins && same; n++)
+        to.bin[n] -= from.bin[n];
+    return h->reconfig(to.bin0, to.binN, (int)to.bins, (HistFlag)to.flags, to.bin, name);
+}
+
+}} // namespace Audinate::chrono
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
@@ -0,0 +1,190 @@
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//
+//
+// 1.   Subject to the terms and conditions of this Licence, Audinate hereby grants you a worldwide, non-exclusive, 
+//      no-charge, royalty free licence to copy, modify, merge, publish, redistribute, sublicense, and/or sell the 
+//      Software, provided always that the following conditions are met: 
+//      1.1.    the Software must accompany, or be incorporated in a licensed Audinate product, solution or offering 
+//              or be used in a product, solution or offering which requires the use of another licensed Audinate 
+//              product, solution or offering. The Software is not for use as a standalone product without any 
+//              reference to Audinate’s products;
+//      1.2.    the Software is provided as part of example code and as guidance material only without any warranty 
+//              or expectation of performance, compatibility, support, updates or security; and
+//      1.3.    the above copyright notice and this License must be included in all copies or substantial portions 
+//              of the Software, and all derivative works of the Software, unless the copies or derivative works are 
+//              solely in the form of machine-executable object code generated by the source language processor.
+//
+// 2.   TO THE EXTENT PERMITTED BY APPLICABLE LAW, THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+//      XPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//      PURPOSE AND NONINFRINGEMENT. 
+//
+// 3.   TO THE FULLEST EXTENT PERMITTED BY APPLICABLE LAW, IN NO EVENT SHALL AUDINATE BE LIABLE ON ANY LEGAL THEORY 
+//      (INCLUDING, WITHOUT LIMITATION, IN AN ACTION FOR BREACH OF CONTRACT, NEGLIGENCE OR OTHERWISE) FOR ANY CLAIM, 
+//      LOSS, DAMAGES OR OTHER LIABILITY HOWSOEVER INCURRED.  WITHOUT LIMITING THE SCOPE OF THE PREVIOUS SENTENCE THE 
+//      EXCLUSION OF LIABILITY SHALL INCLUDE: LOSS OF PRODUCTION OR OPERATION TIME, LOSS, DAMAGE OR CORRUPTION OF 
+//      DATA OR RECORDS; OR LOSS OF ANTICIPATED SAVINGS, OPPORTUNITY, REVENUE, PROFIT OR GOODWILL, OR OTHER ECONOMIC 
+//      LOSS; OR ANY SPECIAL, INCIDENTAL, INDIRECT, CONSEQUENTIAL, PUNITIVE OR EXEMPLARY DAMAGES, ARISING OUT OF OR 
+//      IN CONNECTION WITH THIS AGREEMENT, ACCESS OF THE SOFTWARE OR ANY OTHER DEALINGS WITH THE SOFTWARE, EVEN IF 
+//      AUDINATE HAS BEEN ADVISED OF THE POSSIBILITY OF SUCH CLAIM, LOSS, DAMAGES OR OTHER LIABILITY.
+//
+// 4.   APPLICABLE LEGISLATION SUCH AS THE AUSTRALIAN CONSUMER LAW MAY APPLY REPRESENTATIONS, WARRANTIES, OR CONDITIONS, 
+//      OR IMPOSES OBLIGATIONS OR LIABILITY ON AUDINATE THAT CANNOT BE EXCLUDED, RESTRICTED OR MODIFIED TO THE FULL 
+//      EXTENT SET OUT IN THE EXPRESS TERMS OF THIS CLAUSE ABOVE "CONSUMER GUARANTEES".  TO THE EXTENT THAT SUCH CONSUMER 
+//      GUARANTEES CONTINUE TO APPLY, THEN TO THE FULL EXTENT PERMITTED BY THE APPLICABLE LEGISLATION, THE LIABILITY OF 
+//      AUDINATE UNDER THE RELEVANT CONSUMER GUARANTEE IS LIMITED (WHERE PERMITTED AT AUDINATE’S OPTION) TO ONE OF 
+//      FOLLOWING REMEDIES OR SUBSTANTIALLY EQUIVALENT REMEDIES:
+//      4.1.    THE REPLACEMENT OF THE SOFTWARE, THE SUPPLY OF EQUIVALENT SOFTWARE, OR SUPPLYING RELEVANT SERVICES AGAIN;
+//      4.2.    THE REPAIR OF THE SOFTWARE;
+//      4.3.    THE PAYMENT OF THE COST OF REPLACING THE SOFTWARE, OF ACQUIRING EQUIVALENT SOFTWARE, HAVING THE RELEVANT 
+//              SERVICES SUPPLIED AGAIN, OR HAVING THE SOFTWARE REPAIRED.
+//
+// 5.   This License does not grant any permissions or rights to use the trade marks (whether registered or unregistered), 
+//      the trade names, or product names of Audinate. 
+//
+// 6.   If you choose to redistribute or sell the Software you may elect to offer support, maintenance, warranties, 
+//      indemnities or other liability obligations or rights consistent with this License. However, you may only act on 
+//      your own behalf and must not bind Audinate. You agree to indemnify and hold harmless Audinate, and its affiliates 
+//      form any liability claimed or incurred by reason of your offering or accepting any additional warranty or additional 
+//      liability. 
+//
+//
+// shard.cpp
+//
+
+#include "shard.h"
+#include <assert.h>
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Audinate { namespace hist {
+
+#define SHARD_LINE 64 // Cache line the shards are aligned to
+
+struct shard_t
+{
+    char *    raw;    // As allocated
+    char *    base;   // First shard, aligned
+    int32_t   shards; // Number of shards
+    int32_t   stride; // Bytes from one shard to the next, whole cache lines
+    Histogram shared; // For the threads without a shard
+};
+
+static std::atomic<uint64_t> shardNumbers(0); // A bit for each thread number in use
+
+struct shard_thread_t // A thread's number, across every HistShards, given back when it exits
+{
+    int n = -2; // -2 until the first add, -1 if all of the numbers were in use
+    ~shard_thread_t()
+    {
+        if (n >= 0)
+            shardNumbers.fetch_and(~((uint64_t)1 << n), std::memory_order_release);
+    }
+};
+
+static thread_local shard_thread_t shardThread;
+
+static int shardNumber() // Lowest free number - the release and acquire hand a shard from an exited thread on cleanly
+{
+    uint64_t used = shardNumbers.load(std::memory_order_relaxed);
+    for (int n = 0; n < HIST_SHARDS; n++) {
+        uint64_t bit = (uint64_t)1 << n;
+        if (used & bit)
+            continue;
+        if (shardNumbers.compare_exchange_strong(used, used | bit, std::memory_order_acquire))
+            return n;
+        n = -1; // Lost a race so look again from the start
+    }
+    return -1;
+}
+
+inline Histogram *shardAt(shard_t *p, int n) { return (Histogram *)(p->base + n * p->stride); }
+
+HistShards::HistShards()
+{
+    assert(sizeof(mData) >= sizeof(shard_t)); // Ensure hidden data allocation is sufficient
+    memset(mData, 0, sizeof(shard_t));
+    shard_t *p = (shard_t *)mData;
+    new (&p->shared) Histogram();
+}
+
+static void shardFree(shard_t *p)
+{
+    for (int n = 0; n < p->shards; n++)
+        shardAt(p, n)->~Histogram();
+    free(p->raw);
+    p->raw    = nullptr;
+    p->base   = nullptr;
+    p->shards = 0;
+}
+
+HistShards::~HistShards() { shardFree((shard_t *)mData); }
+
+bool HistShards::config(float bin0, float binN, int bins, HistFlag flags, const char *name, int shards)
+{
+    shard_t *p = (shard_t *)mData;
+    if (shards < 0 || shards > HIST_SHARDS)
+        return false;
+    if (shards != p->shards) { // Not while adding, as for Histogram::config
+        shardFree(p);
+        p->stride = (int32_t)((sizeof(Histogram) + SHARD_LINE - 1) / SHARD_LINE * SHARD_LINE);
+        p->raw    = shards ? (char *)malloc((size_t)shards * p->stride + SHARD_LINE) : nullptr;
+        if (shards && p->raw == nullptr)
+            return false;
+        p->base   = p->raw + (SHARD_LINE - (uintptr_t)p->raw % SHARD_LINE) % SHARD_LINE;
+        p->shards = shards;
+        for (int n = 0; n < shards; n++)
+            new (shardAt(p, n)) Histogram();
+    }
+    bool ok = p->shared.config(bin0, binN, bins, flags, name);
+    for (int n = 0; n < shards; n++)
+        ok = shardAt(p, n)->config(bin0, binN, bins, flags, name) && ok;
+    return ok;
+}
+
+void HistShards::reset()
+{
+    shard_t *p = (shard_t *)mData;
+    p->shared.reset();
+    for (int n = 0; n < p->shards; n++)
+        shardAt(p, n)->reset();
+}
+
+int HistShards::shard()
+{
+    shard_t *p = (shard_t *)mData;
+    if (shardThread.n == -2)
+        shardThread.n = shardNumber();
+    return shardThread.n < p->shards ? shardThread.n : -1;
+}
+
+int HistShards::shards() { return ((shard_t *)mData)->shards; }
+
+void HistShards::add(int shard, float x, HistType n)
+{
+    shard_t *p = (shard_t *)mData;
+    if (shard >= 0 && shard < p->shards)
+        shardAt(p, shard)->add(x, n);
+    else
+        p->shared.addAtomic(x, n);
+}
+
+void HistShards::add(float x, HistType n) { add(shard(), x, n); }
+
+bool HistShards::histogram(Histogram *h) // A copy of the shared one with each shard merged in
+{
+    shard_t *p  = (shard_t *)mData;
+    bool     ok = p->shared.snapshot(h);
+    for (int n = 0; n < p->shards && ok; n++)
+        ok = h->merge(shardAt(p, n));
+    return ok;
+}
+
+}} // namespace Audinate::hist
+
+//
+// Copyright © 2022 Audinate Pty Ltd ACN 120 828 006 (Audinate). All rights reserved. 
+//